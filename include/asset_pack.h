@@ -0,0 +1,44 @@
+#pragma once
+
+#include "mapped_file.h"
+#include <vector>
+
+// a single file holding every asset: a header, an index sorted by name and then the files' bytes.
+// all numbers are little endian.
+const char ASSET_PACK_MAGIC[4] = {'F', 'P', 'A', 'K'};
+const Uint32 ASSET_PACK_VERSION = 1;
+const int ASSET_PACK_NAME_SIZE = 64;
+
+typedef struct
+{
+    char magic[4];
+    Uint32 version;
+    Uint32 entriesCount;
+    Uint32 reserved;
+} AssetPackHeader;
+
+typedef struct
+{
+    // the path the game loads the file with, like res/sprites/0.png, zero padded.
+    char name[ASSET_PACK_NAME_SIZE];
+    Uint64 offset;
+    Uint64 size;
+} AssetPackEntry;
+
+typedef struct
+{
+    MappedFile file;
+    const AssetPackEntry *entries;
+    Uint32 entriesCount;
+} AssetPack;
+
+// packs the files into one pack, each entry is named after the path it was read from.
+bool writeAssetPack(const char *packFilePath, const std::vector<const char *> &filePaths);
+
+// memory maps the pack and checks its header and index, which has to be sorted by name.
+bool openAssetPack(AssetPack &pack, const char *packFilePath);
+
+void closeAssetPack(AssetPack &pack);
+
+// binary search of the index, nullptr when the pack has no such file.
+const AssetPackEntry *findAssetPackEntry(const AssetPack &pack, const char *name);
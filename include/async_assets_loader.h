@@ -0,0 +1,54 @@
+#pragma once
+
+#include "sdl_assets_loader.h"
+#include <vector>
+
+enum AssetType
+{
+    ASSET_IMAGE,
+    ASSET_SOUND
+};
+
+typedef struct
+{
+    const char *filePath;
+    AssetType type;
+    // images are decoded to ARGB8888, or read from the texture cache.
+    SDL_Surface *surface;
+    // sounds are decoded and converted to the format the mixer was opened with.
+    Uint8 *samples;
+    Uint32 samplesLength;
+} AssetRequest;
+
+// decodes images and sounds on a pool of worker threads. creating textures and chunks from the
+// results is left to the main thread, which can keep rendering frames while the workers run.
+typedef struct
+{
+    std::vector<AssetRequest> requests;
+    std::vector<SDL_Thread *> workers;
+    SDL_atomic_t nextRequest;
+    SDL_atomic_t completedRequests;
+
+    int mixerFrequency;
+    Uint16 mixerFormat;
+    int mixerChannels;
+} AsyncAssetsLoader;
+
+// returns the index of the request, requests can only be added before the loader starts.
+int addAssetRequest(AsyncAssetsLoader &loader, const char *filePath, AssetType type);
+
+// workersCount <= 0 uses one worker per cpu core.
+void startAsyncAssetsLoader(AsyncAssetsLoader &loader, int workersCount);
+
+// between 0 and 1.
+float getAsyncAssetsLoaderProgress(AsyncAssetsLoader &loader);
+
+bool isAsyncAssetsLoaderDone(AsyncAssetsLoader &loader);
+
+// joins the workers, call it once the loader is done before reading the requests.
+void finishAsyncAssetsLoader(AsyncAssetsLoader &loader);
+
+// the chunk points into the request samples, which must outlive it.
+Mix_Chunk *createSoundChunk(const AssetRequest &request);
+
+void freeAsyncAssetsLoader(AsyncAssetsLoader &loader);
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "event_queue.h"
+#include <SDL2/SDL.h>
+#include <vector>
+
+// a small mixer on top of SDL_OpenAudioDevice for short sound effects with a low latency.
+// the samples of every sound live in one arena in the device format (16 bit stereo), voices are
+// mixed with saturating adds and a full engine replaces its least important voice.
+const int AUDIO_ENGINE_MAX_VOICES = 16;
+
+typedef struct
+{
+    // in samples into the arena.
+    Uint32 offset;
+    Uint32 framesCount;
+    // a sound only replaces voices of the same or a lower priority.
+    int priority;
+} EngineSound;
+
+typedef struct
+{
+    // -1 for a free voice.
+    int sound;
+    Uint32 position;
+    // voices of the same priority are replaced oldest first.
+    Uint64 startOrder;
+} EngineVoice;
+
+typedef struct
+{
+    SDL_AudioDeviceID device;
+    SDL_AudioSpec spec;
+
+    std::vector<Sint16> samples;
+    std::vector<EngineSound> sounds;
+
+    // only touched by the audio callback.
+    EngineVoice voices[AUDIO_ENGINE_MAX_VOICES];
+    int voicesLimit;
+    Uint64 startedVoices;
+    Uint64 droppedSounds;
+
+    // the sounds to play, from the game thread to the audio callback. no locks on either side.
+    EventQueue requests;
+
+    // time from the input behind a sound to the callback mixing its first samples, plus one buffer until the device plays them.
+    bool isMeasuringLatency;
+    Uint64 measuredSounds;
+    double latencySum;
+    double maxLatency;
+} AudioEngine;
+
+// the device starts paused so sounds can be added, bufferFrames is the size of each callback in sample frames.
+bool openAudioEngine(AudioEngine &engine, int bufferFrames, int voicesLimit);
+
+// samples are 16 bit stereo at the device frequency, like the asset loader converts them when the mixer isn't open.
+// returns the sound to play, or -1. sounds can only be added before the engine starts.
+int addEngineSound(AudioEngine &engine, const Uint8 *samples, Uint32 samplesLength, int priority);
+
+void startAudioEngine(AudioEngine &engine);
+
+// never blocks, the sound is dropped when the queue is full. inputCounter is the SDL_GetPerformanceCounter() of
+// the press or key that caused the sound, 0 for sounds the game plays on its own, which aren't measured.
+void playEngineSound(AudioEngine &engine, int sound, Uint64 inputCounter);
+
+void closeAudioEngine(AudioEngine &engine);
+
+void printAudioEngineStats(const AudioEngine &engine);
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// what a column of birds can hit in one tick. they all share the same x, so the pipes
+// reduce to the opening left between the pairs that overlap that column.
+typedef struct
+{
+    // a bird that was above this before the tick flew over the top of the screen.
+    float ceiling;
+    // the ground is tested with the integer collision box, like SDL_HasIntersection in the game.
+    int groundTop;
+    int groundBottom;
+    float openingTop;
+    float openingBottom;
+    float birdHeight;
+    int birdHeightPixels;
+} BirdCollisionBounds;
+
+enum BirdCollisionKernel
+{
+    COLLISION_KERNEL_SCALAR,
+    COLLISION_KERNEL_SSE2,
+    COLLISION_KERNEL_AVX2,
+    COLLISION_KERNEL_AVX512,
+    COLLISION_KERNEL_COUNT
+};
+
+// picks the widest kernel the cpu runs. call it once at startup, before any thread tests birds,
+// until then the scalar kernel is used.
+void initBirdCollisions();
+
+BirdCollisionKernel getBirdCollisionKernel();
+
+const char *getBirdCollisionKernelName(BirdCollisionKernel kernel);
+
+bool isBirdCollisionKernelSupported(BirdCollisionKernel kernel);
+
+// previousY is where each bird was before the tick and y where it is now. writes 1 to isDying
+// for each bird that hits the ceiling, the ground or a pipe, and 0 for the others.
+void testBirdCollisions(const float *previousY, const float *y, int count, const BirdCollisionBounds &bounds, Uint8 *isDying);
+
+// the same with a given kernel, which must be supported. every kernel writes exactly what the scalar one does.
+void testBirdCollisionsWith(BirdCollisionKernel kernel, const float *previousY, const float *y, int count, const BirdCollisionBounds &bounds,
+                            Uint8 *isDying);
+
+// runs every supported kernel on random and edge case birds against the scalar one and prints their speed.
+// returns false if any of them wrote a different mask.
+bool checkBirdCollisionKernels();
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "game_state.h"
+#include <vector>
+
+// many birds flying the same pipe course in one world, to watch a whole population of bots at once.
+// the pipes and the ground scroll once per tick for every bird. the birds still alive are packed at the
+// front of the per bird arrays, a bird that dies is swapped out so a tick only ever touches the living.
+typedef struct
+{
+    GameDimensions dimensions;
+    SDL_Rect groundCollisionBounds;
+    float impulse;
+    float gravityIncrement;
+
+    PipePairs pipes;
+    PipeCourse pipeCourse;
+    float distanceSinceLastPipe;
+    Vector2 groundPositions[GROUND_TILES_COUNT];
+    Vector2 previousGroundPositions[GROUND_TILES_COUNT];
+    float startGameTimer;
+
+    // every bird flies at the same x, so all the living ones have passed the same pipes.
+    int score;
+    Uint64 tick;
+
+    int birdsCount;
+    int aliveCount;
+
+    // one slot per living bird, only [0, aliveCount) is used.
+    std::vector<float> y;
+    std::vector<float> previousY;
+    std::vector<float> speed;
+    std::vector<float> angle;
+    std::vector<float> previousAngle;
+    std::vector<float> downRotationTimer;
+    std::vector<Uint8> isDying;
+    // the bird in each slot.
+    std::vector<int> birdIds;
+
+    // indexed by bird id, the score is final once the bird is dead.
+    std::vector<Uint8> isAlive;
+    std::vector<int> scores;
+    // the tick and the height at which each dead bird died.
+    std::vector<Uint64> deathTicks;
+    std::vector<float> deathY;
+} BirdFlock;
+
+void initBirdFlock(BirdFlock &flock, const GameDimensions &dimensions, int birdsCount, Uint64 seed);
+
+// brings every bird back to the start of the same course.
+void resetBirdFlock(BirdFlock &flock);
+
+// flaps has one entry per living bird in slot order, non zero to flap. the physics are the ones of the game,
+// so a bird here lives exactly as long as it would alone in a GameState. returns the birds that died.
+int stepBirdFlock(BirdFlock &flock, const Uint8 *flaps, float deltaTime);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "bot_trainer.h"
+#include <vector>
+
+// bots are evaluated in blocks of this many, one per lane of an avx2 register.
+const int BOT_BATCH_LANES = 8;
+
+// the networks of many bots evaluated together. the slots are grouped in blocks of BOT_BATCH_LANES,
+// and a block stores each weight of its bots side by side, weight after weight. evaluating a block
+// reads one contiguous run of memory, and the same weight of all its bots is a single vector load.
+// the inputs are laid out the same way.
+typedef struct
+{
+    int botsCount;
+    int blocksCount;
+    std::vector<float> weights;
+    std::vector<float> inputs;
+    // the decision of each slot after runBotBatch().
+    std::vector<Uint8> flaps;
+
+    // the bot whose weights are in each slot, and the slot of each bot.
+    std::vector<int> slotBots;
+    std::vector<int> botSlots;
+} BotBatch;
+
+enum BotBatchKernel
+{
+    BOT_BATCH_KERNEL_SCALAR,
+    BOT_BATCH_KERNEL_AVX2,
+    BOT_BATCH_KERNEL_COUNT
+};
+
+// bot i starts in slot i.
+void initBotBatch(BotBatch &batch, const BotGenome *genomes, int botsCount);
+
+void setBotBatchInputs(BotBatch &batch, int slot, const float inputs[BOT_INPUTS_COUNT]);
+
+// follows the birds of a flock after dead ones were swapped out: slotBirds[slot] is the bird now in each slot.
+// only works with the swaps of one flock step, a restarted flock needs a new batch.
+void syncBotBatchSlots(BotBatch &batch, const int *slotBirds, int slotsCount);
+
+// decides for the slots [0, slotsCount) with the fastest kernel the cpu runs.
+void runBotBatch(BotBatch &batch, int slotsCount);
+
+void runBotBatchWith(BotBatchKernel kernel, BotBatch &batch, int slotsCount);
+
+// picks the fastest kernel the cpu runs. call it once at startup, before any thread runs a batch,
+// until then the scalar kernel is used.
+void initBotBatchKernel();
+
+BotBatchKernel getBotBatchKernel();
+
+const char *getBotBatchKernelName(BotBatchKernel kernel);
+
+bool isBotBatchKernelSupported(BotBatchKernel kernel);
+
+// prints the bots per second of each kernel and how many of their decisions match isBotFlapping().
+void benchmarkBotBatch(int botsCount);
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "game_state.h"
+#include "random_generator.h"
+
+// what a bot sees each tick: its height, its vertical speed, how far the next pipe is
+// and where the next two gaps are compared to the bird.
+const int BOT_INPUTS_COUNT = 5;
+const int BOT_HIDDEN_COUNT = 8;
+// a bias per hidden neuron and for the output.
+const int BOT_WEIGHTS_COUNT = (BOT_INPUTS_COUNT + 1) * BOT_HIDDEN_COUNT + BOT_HIDDEN_COUNT + 1;
+
+// the first weights are the hidden neurons one after the other, each with its inputs then its bias,
+// followed by the output weights and the output bias.
+const int BOT_OUTPUT_WEIGHTS = (BOT_INPUTS_COUNT + 1) * BOT_HIDDEN_COUNT;
+
+// a rational tanh, exact at 0 and reaching -1 and 1 at -3 and 3. every batch kernel computes the very same
+// operations as isBotFlapping(), with no fused multiply adds, so a bot decides the same alone or in a batch.
+inline float approximateTanh(float x)
+{
+    x = SDL_clamp(x, -3.0f, 3.0f);
+    float squared = x * x;
+
+    return x * (27 + squared) / (27 + 9 * squared);
+}
+
+// the weights of a small fixed network, the bot flaps when its output is positive.
+typedef struct
+{
+    float weights[BOT_WEIGHTS_COUNT];
+} BotGenome;
+
+typedef struct
+{
+    int populationSize;
+    int generationsCount;
+    // every bot of a generation flies the course of this seed.
+    Uint64 courseSeed;
+    // seeds the mutations and the selection.
+    Uint64 trainingSeed;
+    int tickRate;
+    // an evaluation ends after this many ticks even if the bot is still alive.
+    int maxTicks;
+    // the best ones are copied unchanged into the next generation.
+    int elitesCount;
+    float mutationRate;
+    float mutationStrength;
+    // 0 uses every cpu core.
+    int workersCount;
+} BotTrainerSettings;
+
+void initBotTrainerSettings(BotTrainerSettings &settings);
+
+// the inputs of any bird flying in front of the pipes, not only the one of a game.
+void getBirdBotInputs(const PipePairs &pipes, const GameDimensions &dimensions, float birdY, float speed, float impulse,
+                      float inputs[BOT_INPUTS_COUNT]);
+
+void getBotInputs(const GameState &game, float inputs[BOT_INPUTS_COUNT]);
+
+bool isBotFlapping(const BotGenome &genome, const float inputs[BOT_INPUTS_COUNT]);
+
+bool shouldBotFlap(const BotGenome &genome, const GameState &game);
+
+// adds gaussian noise to each weight with a chance of mutationRate.
+void mutateBotGenome(BotGenome &genome, float mutationRate, float mutationStrength, RandomGenerator &random);
+
+// the ticks survived plus a bonus per pipe, minus a bit for how far from the next gap the bird ended.
+float getBotFitness(Uint64 ticks, int score, float gapOffset, const BotTrainerSettings &settings);
+
+// evolves a population, each generation flying as flocks of bots with batched inference,
+// and prints the progress and the throughput. returns the best bot found.
+BotGenome trainBots(const BotTrainerSettings &settings, const GameDimensions &dimensions);
+
+bool saveBotGenome(const char *filePath, const BotGenome &genome);
+
+bool loadBotGenome(const char *filePath, BotGenome &genome);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+const int EVENT_QUEUE_SIZE = 256;
+
+typedef struct
+{
+    int code;
+    // SDL_GetPerformanceCounter() when the input behind the event happened, 0 when there's none.
+    Uint64 inputCounter;
+} QueuedEvent;
+
+// a bounded queue of events from one producer thread to one consumer thread, without locks.
+// it carries the game events to the simulation thread and the sounds to the audio callback.
+typedef struct
+{
+    QueuedEvent events[EVENT_QUEUE_SIZE];
+    SDL_atomic_t writtenEvents;
+    SDL_atomic_t readEvents;
+} EventQueue;
+
+void initEventQueue(EventQueue &queue);
+
+// returns false when the queue is full and the event was dropped.
+bool pushQueuedEvent(EventQueue &queue, int code, Uint64 inputCounter);
+
+bool popQueuedEvent(EventQueue &queue, QueuedEvent &event);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+
+enum FramePhase
+{
+    PHASE_EVENTS,
+    PHASE_UPDATE,
+    PHASE_RENDER,
+    PHASE_PRESENT,
+    PHASE_PACING,
+    PHASE_COUNT
+};
+
+// about 4 seconds of history at 60 fps.
+const int PROFILER_HISTORY_SIZE = 256;
+
+typedef struct
+{
+    // phase durations in milliseconds, one ring buffer per phase.
+    float samples[PHASE_COUNT][PROFILER_HISTORY_SIZE];
+    int frameIndex;
+    int recordedFrames;
+    Uint64 lastMark;
+    Uint64 frequency;
+} FrameProfiler;
+
+typedef struct
+{
+    float current;
+    float p50;
+    float p99;
+    float max;
+} PhaseStats;
+
+void initFrameProfiler(FrameProfiler &profiler);
+
+// starts timing a new frame, the first phase is measured from here.
+void beginProfilerFrame(FrameProfiler &profiler);
+
+// stores the time since the previous mark as the duration of the phase that just ended.
+void markProfilerPhase(FrameProfiler &profiler, FramePhase phase);
+
+void endProfilerFrame(FrameProfiler &profiler);
+
+PhaseStats getPhaseStats(const FrameProfiler &profiler, FramePhase phase);
+
+const char *getPhaseName(FramePhase phase);
+
+std::string formatPhaseStats(const FrameProfiler &profiler, FramePhase phase);
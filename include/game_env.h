@@ -0,0 +1,57 @@
+#pragma once
+
+#include "game_state.h"
+#include "bot_trainer.h"
+#include "thread_pool.h"
+#include <vector>
+
+// an observation is what a bot sees, see getBotInputs().
+const int GAME_ENV_OBSERVATION_SIZE = BOT_INPUTS_COUNT;
+
+// instances stepped by one thread pool task.
+const int GAME_ENV_BATCH_SIZE = 512;
+
+// many independent games stepped together for reinforcement learning, each with its own course.
+// the games live side by side in one array, and the results of a step are flat arrays with one
+// entry per instance, ready to be copied into a training framework.
+typedef struct
+{
+    int instancesCount;
+    Uint64 seed;
+    float deltaTime;
+    // an episode that lasts this many ticks ends as done, 0 lets it run until the bird dies.
+    Uint64 maxEpisodeTicks;
+
+    std::vector<GameState> games;
+    // episodes finished or cut short by a reset in each instance, picks the course of its next one.
+    std::vector<Uint32> episodes;
+
+    // instancesCount * GAME_ENV_OBSERVATION_SIZE floats, instance after instance.
+    std::vector<float> observations;
+    // 1 for each pipe passed in the step, -1 for dying.
+    std::vector<float> rewards;
+    // the episode ended in this step and the instance started a new one, its observation is already the new one's.
+    std::vector<Uint8> dones;
+    // the episode was done because it reached maxEpisodeTicks with the bird still alive, not because it died.
+    std::vector<Uint8> truncations;
+    // the score, length and course of the episode that ended, only set where done is.
+    std::vector<int> episodeScores;
+    std::vector<Uint64> episodeTicks;
+    std::vector<Uint64> episodeSeeds;
+
+    ThreadPool pool;
+    // the actions of the step being run.
+    const Uint8 *actions;
+} GameEnv;
+
+// 0 workers uses one per cpu core. every instance starts its first episode and has an observation.
+void createGameEnv(GameEnv &env, int instancesCount, Uint64 seed, const GameDimensions &dimensions, int tickRate, int workersCount);
+
+// cuts the episode of every instance short and starts a new one on the next course.
+void resetGameEnv(GameEnv &env);
+
+// actions has one entry per instance, non zero to flap. runs one tick of every instance and fills
+// the observations, rewards, dones and truncations. an instance that died starts over on the spot.
+void stepGameEnv(GameEnv &env, const Uint8 *actions);
+
+void destroyGameEnv(GameEnv &env);
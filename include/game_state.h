@@ -0,0 +1,116 @@
+#pragma once
+
+#include "sdl_starter.h"
+#include "pipe_pairs.h"
+#include "pipe_course.h"
+#include "input_recorder.h"
+
+const float PIPE_GAP_HEIGHT = 80;
+
+// pixels scrolled between two pipes, 2 seconds at the scroll speed.
+const float PIPE_SPACING = 300;
+
+// pixels per second the pipes and the ground move to the left.
+const float SCROLL_SPEED = 150;
+
+const int GROUND_TILES_COUNT = 4;
+
+// the rectangle drawn for the bird in the simple graphics mode.
+const int SIMPLE_BIRD_WIDTH = 34;
+const int SIMPLE_BIRD_HEIGHT = 24;
+
+typedef struct
+{
+    float x;
+    float y;
+} Vector2;
+
+// the sizes of the sprites the bird collides with, the simulation doesn't need the sprites themselves.
+typedef struct
+{
+    int birdWidth;
+    int birdHeight;
+    int pipeWidth;
+    int pipeHeight;
+    int groundWidth;
+    int groundHeight;
+} GameDimensions;
+
+// sounds a step asks the caller to play, as bits.
+enum GameSound
+{
+    GAME_SOUND_FLAP = 1,
+    GAME_SOUND_PAUSE = 2,
+    GAME_SOUND_DIE = 4,
+    GAME_SOUND_POINT = 8
+};
+
+typedef struct
+{
+    Uint32 sounds;
+    // a reset ended a run that was over, with this score and duration in ticks.
+    bool isRunFinished;
+    int finishedRunScore;
+    Uint64 finishedRunTicks;
+    Uint64 finishedRunSeed;
+    bool isNewHighScore;
+} GameStepResult;
+
+// everything a game is made of. it doesn't touch any global, so any number of games can run at once,
+// each one on any thread, and the same seed and inputs always give the same game.
+typedef struct
+{
+    GameDimensions dimensions;
+    SDL_Rect groundCollisionBounds;
+
+    float playerY;
+    // the bird's collision box, only moved while the bird falls.
+    SDL_Rect birdBounds;
+    // vertical speed, reset by a flap.
+    float gravity;
+    float impulse;
+    float gravityIncrement;
+
+    float angle;
+    bool shouldRotateUp;
+    float upRotationTimer;
+    float downRotationTimer;
+    float startGameTimer;
+
+    bool isGameOver;
+    bool isGamePaused;
+    // the simple graphics also change the bird that goes over the top of the screen.
+    bool isSimpleGraphicsMode;
+
+    int score;
+    int highScore;
+
+    Vector2 groundPositions[GROUND_TILES_COUNT];
+
+    PipePairs pipes;
+    PipeCourse pipeCourse;
+    float distanceSinceLastPipe;
+
+    // state of the previous tick, a renderer can interpolate between it and the current one.
+    float previousPlayerY;
+    float previousAngle;
+    Vector2 previousGroundPositions[GROUND_TILES_COUNT];
+
+    Uint64 seed;
+    // ticks run since the game started.
+    Uint64 tick;
+    Uint64 runStartTick;
+} GameState;
+
+void initGameState(GameState &game, const GameDimensions &dimensions, Uint64 seed);
+
+GameStepResult applyGameInput(GameState &game, InputAction action);
+
+// applies the inputs in order, then runs one tick of deltaTime seconds unless the game is over or paused.
+GameStepResult stepGame(GameState &game, const InputAction *inputs, int inputsCount, float deltaTime);
+
+// true while the game is over or paused, when only an input can change it.
+bool isGameWaiting(const GameState &game);
+
+// a scripted player for soak runs, flaps whenever the bird falls below the gap it's heading to.
+bool shouldAutopilotFlap(const GameState &game);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "sprite_batch.h"
+#include <SDL2/SDL_ttf.h>
+
+// printable ascii.
+const int GLYPH_ATLAS_FIRST_CHARACTER = 32;
+const int GLYPH_ATLAS_LAST_CHARACTER = 126;
+const int GLYPH_ATLAS_CHARACTERS_COUNT = GLYPH_ATLAS_LAST_CHARACTER - GLYPH_ATLAS_FIRST_CHARACTER + 1;
+
+// every glyph of a font rasterized once into a single texture, so changing text is only a matter of
+// drawing different quads instead of rasterizing and uploading a new texture.
+typedef struct
+{
+    SDL_Texture *texture;
+    // each glyph is a full cell of the font's height, one advance wide.
+    SDL_Rect glyphs[GLYPH_ATLAS_CHARACTERS_COUNT];
+    int lineHeight;
+} GlyphAtlas;
+
+bool buildGlyphAtlas(SDL_Renderer *renderer, TTF_Font *font, GlyphAtlas &atlas);
+
+void destroyGlyphAtlas(GlyphAtlas &atlas);
+
+// characters outside the atlas are drawn as spaces. returns the width of the text.
+int drawText(SpriteBatch &batch, const GlyphAtlas &atlas, const char *text, int x, int y);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// saves the high score on its own thread, so the game thread never waits on the disk.
+// only the latest requested score is kept, several requests before the thread wakes up end in a single write.
+typedef struct
+{
+    const char *filePath;
+    SDL_Thread *thread;
+    SDL_mutex *mutex;
+    SDL_cond *condition;
+    int pendingScore;
+    bool hasPendingScore;
+    bool isStopping;
+} HighScoreWriter;
+
+// a missing, empty or corrupted file reads as 0.
+int loadHighScore(const char *filePath);
+
+// writes a temporary file, flushes it to the disk and renames it over the old one,
+// so a crash at any point leaves either the old or the new contents.
+bool writeFileAtomically(const char *filePath, const void *data, size_t size);
+
+// without a thread the scores are written directly on request.
+void startHighScoreWriter(HighScoreWriter &writer, const char *filePath);
+
+void requestHighScoreSave(HighScoreWriter &writer, int score);
+
+// writes the pending score, if any, before returning.
+void stopHighScoreWriter(HighScoreWriter &writer);
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+enum InputAction
+{
+    INPUT_FLAP,
+    INPUT_PAUSE,
+    INPUT_RESET
+};
+
+typedef struct
+{
+    // number of simulation ticks run before the input was applied.
+    Uint64 tick;
+    InputAction action;
+} RecordedInput;
+
+// everything needed to run a session again: the seed of the pipe course, the tick rate and the inputs.
+// the final tick and score are stored to check that a replay ends the same way.
+typedef struct
+{
+    Uint64 seed;
+    int tickRate;
+    std::vector<RecordedInput> inputs;
+    Uint64 finalTick;
+    int finalScore;
+} InputRecording;
+
+void recordInput(InputRecording &recording, Uint64 tick, InputAction action);
+
+bool saveInputRecording(const InputRecording &recording, const char *filePath);
+
+bool loadInputRecording(InputRecording &recording, const char *filePath);
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// a whole file mapped read only into memory.
+typedef struct
+{
+    const Uint8 *data;
+    size_t size;
+    // platform handles of the mapping.
+    void *file;
+    void *mapping;
+} MappedFile;
+
+// fails for missing and empty files.
+bool mapFile(MappedFile &mappedFile, const char *filePath);
+
+void unmapFile(MappedFile &mappedFile);
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "random_generator.h"
+
+// layouts are generated in batches this size, ahead of the pipes being spawned.
+const int PIPE_COURSE_LOOKAHEAD = 64;
+
+typedef struct
+{
+    float gapCenter;
+    float gapHeight;
+} PipeLayout;
+
+// the sequence of pipe gaps of a run, fully determined by its seed.
+typedef struct
+{
+    RandomGenerator random;
+    Uint64 seed;
+    float lowestGapCenter;
+    int gapCenterRange;
+    float gapHeight;
+
+    PipeLayout layouts[PIPE_COURSE_LOOKAHEAD];
+    int nextLayout;
+    int layoutsCount;
+} PipeCourse;
+
+// gap centers are uniform in (lowestGapCenter - gapCenterRange, lowestGapCenter].
+void initPipeCourse(PipeCourse &course, Uint64 seed, float lowestGapCenter, int gapCenterRange, float gapHeight);
+
+// starts the course over from its seed.
+void restartPipeCourse(PipeCourse &course);
+
+PipeLayout nextPipeLayout(PipeCourse &course);
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// at most SCREEN_WIDTH / PIPE_SPACING + 2 pairs are alive at once, the ones on screen, the one spawning and the one
+// leaving, about 5. rounded up to a power of two with room to spare, and small enough that a game stays compact.
+// must be a power of two.
+const int PIPE_PAIRS_CAPACITY = 16;
+
+// up and down pipes are stored together as one pair per gap, in separate arrays so the
+// scroll and collision kernel can process several pairs per instruction.
+// pairs spawn at the right and leave at the left in the same order, so the arrays are used as a ring buffer.
+typedef struct
+{
+    float x[PIPE_PAIRS_CAPACITY];
+    float previousX[PIPE_PAIRS_CAPACITY];
+    float gapCenter[PIPE_PAIRS_CAPACITY];
+    float gapHeight[PIPE_PAIRS_CAPACITY];
+    // 0 or all bits set, so it can be used as a simd mask.
+    Sint32 isBehind[PIPE_PAIRS_CAPACITY];
+    int first;
+    int count;
+} PipePairs;
+
+typedef struct
+{
+    bool isBirdColliding;
+    // pairs the bird got past in this step.
+    int passedPairs;
+} PipePairsStep;
+
+inline int getPipePairIndex(const PipePairs &pairs, int index)
+{
+    return (pairs.first + index) & (PIPE_PAIRS_CAPACITY - 1);
+}
+
+void pushPipePair(PipePairs &pairs, float x, float gapCenter, float gapHeight);
+
+void popPipePair(PipePairs &pairs);
+
+void clearPipePairs(PipePairs &pairs);
+
+void savePipePairsPositions(PipePairs &pairs);
+
+// scrolls every pair to the left by distance and tests the bird against every gap in one pass.
+PipePairsStep movePipePairs(PipePairs &pairs, float distance, const SDL_FRect &bird, float pipeWidth);
+
+// the opening left by the pairs that overlap [left, right) horizontally, a bird inside it touches none of them.
+// returns false when no pair overlaps.
+bool findPipeOpening(const PipePairs &pairs, float left, float right, float pipeWidth, float &openingTop, float &openingBottom);
+
+// pops the pairs at the front that are completely off screen.
+void removePassedPipePairs(PipePairs &pairs, float pipeWidth);
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// xoshiro128** seeded through splitmix64, each game owns its generator so runs can be reproduced from the seed.
+typedef struct
+{
+    Uint32 state[4];
+} RandomGenerator;
+
+void seedRandomGenerator(RandomGenerator &random, Uint64 seed);
+
+Uint32 nextRandom(RandomGenerator &random);
+
+// uniform in [0, bound) without modulo bias.
+Uint32 nextRandomBounded(RandomGenerator &random, Uint32 bound);
+
+// uniform in [0, 1).
+float nextRandomFloat(RandomGenerator &random);
+
+// a seed that changes every launch, for when the player doesn't pass one.
+Uint64 makeRandomSeed();
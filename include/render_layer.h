@@ -0,0 +1,26 @@
+#pragma once
+
+#include "sprite_batch.h"
+
+// a render target texture holding content that rarely changes, composed once and then drawn as a single quad
+// until it's marked dirty again.
+typedef struct
+{
+    SDL_Texture *texture;
+    SDL_Rect bounds;
+    bool isDirty;
+} RenderLayer;
+
+// returns false when the renderer has no render targets, the caller should keep drawing the content directly.
+bool initRenderLayer(SDL_Renderer *renderer, RenderLayer &layer, SDL_Rect bounds, bool isTransparent);
+
+void destroyRenderLayer(RenderLayer &layer);
+
+void markRenderLayerDirty(RenderLayer &layer);
+
+// redirects the batch into the layer, the content is drawn relative to the layer's top left corner.
+void beginRenderLayer(SpriteBatch &batch, RenderLayer &layer);
+
+void endRenderLayer(SpriteBatch &batch, RenderLayer &layer);
+
+void drawRenderLayer(SpriteBatch &batch, const RenderLayer &layer);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "mapped_file.h"
+#include <string>
+#include <vector>
+
+// every finished run is appended to a log of fixed size records, and a separate index keeps them sorted by score,
+// so leaderboard queries are binary searches of the memory mapped index instead of scans of the log.
+// the log records that aren't in the index yet are kept in memory and merged into it once there are
+// RUN_HISTORY_TAIL_LIMIT of them. several processes can add runs to the same log, each append locks the log.
+// all numbers in both files are little endian.
+const char RUN_HISTORY_INDEX_MAGIC[4] = {'F', 'R', 'I', 'X'};
+const Uint32 RUN_HISTORY_INDEX_VERSION = 1;
+// log records past the index before they are merged into the index file.
+const size_t RUN_HISTORY_TAIL_LIMIT = 16384;
+
+typedef struct
+{
+    // seconds since the unix epoch.
+    Sint64 timestamp;
+    Uint64 seed;
+    Sint32 score;
+    Uint32 durationMilliseconds;
+} RunRecord;
+
+typedef struct
+{
+    char magic[4];
+    Uint32 version;
+    // log records covered by the index, the ones after it are added to the tail on open.
+    Uint64 recordsCount;
+} RunIndexHeader;
+
+// sorted by score from highest to lowest, ties by the order the runs were added.
+typedef struct
+{
+    Sint32 score;
+    Uint32 reserved;
+    Uint64 recordIndex;
+} RunIndexEntry;
+
+typedef struct
+{
+    std::string logFilePath;
+    std::string indexFilePath;
+    // a HANDLE on windows, a file descriptor plus one elsewhere, 0 when closed.
+    intptr_t logFile;
+    // records in the log the last time this process read or appended to it.
+    Uint64 recordsCount;
+    MappedFile index;
+    const RunIndexEntry *indexEntries;
+    Uint64 indexEntriesCount;
+    // runs not in the index file yet in the order they were added, in host byte order.
+    std::vector<RunIndexEntry> tail;
+} RunHistory;
+
+// the index lives next to the log with an .idx extension, it's rebuilt from the log when missing or invalid.
+bool openRunHistory(RunHistory &history, const char *logFilePath);
+
+// the runs still in the tail stay in the log, the next open reads them back.
+void closeRunHistory(RunHistory &history);
+
+void addRun(RunHistory &history, const RunRecord &record);
+
+// merges every log record past the index into the index file, including the ones of other processes, and maps it again.
+bool mergeRunHistoryIndex(RunHistory &history);
+
+// 1 for the best score, ties share the same rank.
+Uint64 getRunRank(const RunHistory &history, int score);
+
+// the best runs first.
+std::vector<RunIndexEntry> getTopRuns(const RunHistory &history, size_t count);
+
+bool readRunRecord(RunHistory &history, Uint64 recordIndex, RunRecord &record);
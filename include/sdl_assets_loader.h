@@ -10,10 +10,19 @@ typedef struct
 {
     SDL_Texture *texture;
     SDL_Rect textureBounds;
+    // region of the texture to draw, the whole texture unless it comes from an atlas.
+    SDL_Rect sourceBounds;
 } Sprite;
 
-Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, int positionY);
+// files found in a mounted pack are read from memory instead of the file system.
+bool mountAssetPack(const char *packFilePath);
+
+void unmountAssetPack();
 
-Mix_Chunk *loadSound(const char *filePath);
+// the rw reads from the mounted pack when it has the file, otherwise from the file system.
+SDL_RWops *openAsset(const char *filePath);
+
+Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, int positionY);
 
-void updateTextureText(SDL_Texture *&texture, const char *text, TTF_Font *&fontSquare, SDL_Renderer *renderer);
\ No newline at end of file
+// only reads the image size, for code paths that run without a renderer.
+Sprite loadSpriteBounds(const char *filePath, int positionX, int positionY);
\ No newline at end of file
@@ -10,6 +10,32 @@ const int SCREEN_WIDTH = 960;
 const int SCREEN_HEIGHT = 544;
 const int FRAME_RATE = 60;
 
-int startSDL(SDL_Window *window, SDL_Renderer *renderer);
+// without the mixer the audio subsystem is still initialized, for a device opened by the caller.
+int startSDL(SDL_Window *window, SDL_Renderer *renderer, bool isMixerEnabled);
 
-void capFrameRate(Uint32 currentFrameTime);
+typedef struct
+{
+    Uint64 frequency;
+    Uint64 frameDuration;
+    Uint64 nextDeadline;
+    Uint64 lastFrameEnd;
+    // when vsync already presents at the target rate the pacer only measures.
+    bool isVSyncPacing;
+
+    // difference between each measured frame time and the target, in milliseconds.
+    int measuredFrames;
+    double errorSum;
+    double squaredErrorSum;
+    double maxError;
+} FramePacer;
+
+// paces any loop at a fixed rate without relying on vsync, like the simulation thread.
+void initFixedRatePacer(FramePacer &pacer, int rate);
+
+// frameRate <= 0 uses the refresh rate of the window's display.
+void initFramePacer(FramePacer &pacer, SDL_Window *window, SDL_Renderer *renderer, int frameRate);
+
+// sleeps until the absolute deadline of the next frame, spinning for the last couple of milliseconds.
+void waitForNextFrame(FramePacer &pacer);
+
+void printFramePacerStats(const FramePacer &pacer);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "sdl_assets_loader.h"
+#include <vector>
+
+// collects textured and colored quads and submits them with as few SDL_RenderGeometry calls as possible.
+// the pending quads are flushed whenever the texture changes, so sprites from one atlas end up in one call.
+typedef struct
+{
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    float textureWidth;
+    float textureHeight;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    // SDL_RenderGeometry calls since the last beginSpriteBatch().
+    int drawCalls;
+} SpriteBatch;
+
+void initSpriteBatch(SpriteBatch &batch, SDL_Renderer *renderer, int quadsCapacity);
+
+void beginSpriteBatch(SpriteBatch &batch);
+
+// angle is in degrees clockwise around the center of the destination, like SDL_RenderCopyEx.
+void drawTexturedQuad(SpriteBatch &batch, SDL_Texture *texture, const SDL_Rect &source, const SDL_FRect &destination, float angle);
+
+void drawSprite(SpriteBatch &batch, const Sprite &sprite);
+
+void drawFilledQuad(SpriteBatch &batch, const SDL_Rect &bounds, SDL_Color color);
+
+void flushSpriteBatch(SpriteBatch &batch);
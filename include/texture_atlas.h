@@ -0,0 +1,24 @@
+#pragma once
+
+#include "sdl_assets_loader.h"
+
+typedef struct
+{
+    SDL_Texture *texture;
+    int width;
+    int height;
+} TextureAtlas;
+
+typedef struct
+{
+    const char *filePath;
+    int positionX;
+    int positionY;
+    // filled with the atlas texture and the region of this image inside it.
+    Sprite *sprite;
+} AtlasEntry;
+
+// packs the already decoded images into a single texture so render() doesn't switch textures between sprites.
+// surfaces[i] is the image of entries[i] and stays owned by the caller.
+// returns false when an image is missing or they don't fit in the renderer's max texture size.
+bool buildTextureAtlas(SDL_Renderer *renderer, AtlasEntry entries[], SDL_Surface *surfaces[], int entriesCount, TextureAtlas &atlas);
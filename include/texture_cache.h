@@ -0,0 +1,43 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// decoded images are stored as raw ARGB8888 pixels, the native texture format of the software,
+// direct3d and opengl renderers, in one file per image named after the hash of its path.
+// the header keeps the hash of the source bytes, a changed image fails the check and its file is
+// written over, so the cache never holds more than one file per asset.
+const char TEXTURE_CACHE_MAGIC[4] = {'F', 'T', 'E', 'X'};
+const Uint32 TEXTURE_CACHE_VERSION = 1;
+
+typedef struct
+{
+    char magic[4];
+    Uint32 version;
+    Uint64 sourceHash;
+    Uint64 sourceSize;
+    Uint32 pixelFormat;
+    Sint32 width;
+    Sint32 height;
+    Sint32 pitch;
+} TextureCacheHeader;
+
+// creates the cache folder, an empty path disables the cache.
+void initTextureCache(const char *directoryPath);
+
+bool isTextureCacheEnabled();
+
+// FNV-1a 64.
+Uint64 hashBytes(const void *data, size_t size);
+
+// decodes the image, or reads its pixels from the cache when it was decoded on an earlier run.
+// the surface is always ARGB8888, nullptr when the image can't be loaded.
+SDL_Surface *loadCachedImage(const char *filePath);
+
+// decodes the image without looking at the cache.
+SDL_Surface *decodeImage(const char *filePath);
+
+// uploads the pixels with SDL_CreateTexture and SDL_UpdateTexture, the surface must be ARGB8888.
+SDL_Texture *createTextureFromPixels(SDL_Renderer *renderer, SDL_Surface *surface);
+
+// times every image decoded from the source files against read from the cache, and prints both.
+void benchmarkTextureCache(const char *filePaths[], int filePathsCount, int rounds);
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+const int THREAD_POOL_MAX_WORKERS = 64;
+
+// runs the task with index in [0, tasksCount).
+typedef void (*ThreadPoolTask)(void *data, int index);
+
+// the task indices a worker still has to run. the owner takes them from the front,
+// a worker that ran out of its own steals the back half.
+typedef struct
+{
+    SDL_SpinLock lock;
+    int begin;
+    int end;
+} WorkerTasks;
+
+struct ThreadPool;
+
+typedef struct
+{
+    struct ThreadPool *pool;
+    int workerIndex;
+} PoolWorker;
+
+// the calling thread is worker 0 and runs tasks too, the others are SDL threads waiting for a batch.
+typedef struct ThreadPool
+{
+    int workersCount;
+    SDL_Thread *threads[THREAD_POOL_MAX_WORKERS];
+    PoolWorker workers[THREAD_POOL_MAX_WORKERS];
+    WorkerTasks tasks[THREAD_POOL_MAX_WORKERS];
+
+    SDL_mutex *mutex;
+    SDL_cond *batchStarted;
+    SDL_cond *batchFinished;
+    ThreadPoolTask task;
+    void *taskData;
+    // bumped for every batch, so a worker knows there's new work.
+    int batch;
+    int busyWorkers;
+    bool isStopping;
+} ThreadPool;
+
+// 0 workers uses one per cpu core. without threads everything runs on the calling thread.
+void startThreadPool(ThreadPool &pool, int workersCount);
+
+// returns once every task of the batch has run.
+void runThreadPoolTasks(ThreadPool &pool, int tasksCount, ThreadPoolTask task, void *data);
+
+void stopThreadPool(ThreadPool &pool);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// hands the latest of a stream of values from one producer thread to one consumer thread without locks.
+// the caller owns three slots, the buffer tracks which one each side is using. the producer never waits
+// for the consumer, and the consumer always gets the newest published value, skipping the ones it missed.
+typedef struct
+{
+    // only touched by the producer.
+    int backSlot;
+    // only touched by the consumer.
+    int frontSlot;
+    // the slot between them, with TRIPLE_BUFFER_FRESH set while it holds a value the consumer hasn't taken.
+    SDL_atomic_t middleSlot;
+} TripleBuffer;
+
+const int TRIPLE_BUFFER_FRESH = 4;
+
+void initTripleBuffer(TripleBuffer &buffer);
+
+// the slot the producer writes next.
+int getTripleBufferBack(const TripleBuffer &buffer);
+
+// makes the back slot the newest value and hands the producer another one.
+void publishTripleBuffer(TripleBuffer &buffer);
+
+// returns true when the front slot changed to a newer value.
+bool takeTripleBufferFront(TripleBuffer &buffer);
+
+int getTripleBufferFront(const TripleBuffer &buffer);
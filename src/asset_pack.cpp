@@ -0,0 +1,136 @@
+#include "asset_pack.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+bool writeAssetPack(const char *packFilePath, const std::vector<const char *> &filePaths)
+{
+    std::vector<std::string> names(filePaths.begin(), filePaths.end());
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    std::vector<AssetPackEntry> entries(names.size());
+    std::vector<std::string> contents(names.size());
+
+    Uint64 offset = sizeof(AssetPackHeader) + names.size() * sizeof(AssetPackEntry);
+
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (names[i].size() >= (size_t)ASSET_PACK_NAME_SIZE)
+        {
+            printf("The asset path %s is too long for the pack\n", names[i].c_str());
+            return false;
+        }
+
+        std::ifstream file(names[i], std::ios::binary);
+
+        if (!file.is_open())
+        {
+            printf("Failed to read %s\n", names[i].c_str());
+            return false;
+        }
+
+        contents[i].assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        memset(&entries[i], 0, sizeof(AssetPackEntry));
+        memcpy(entries[i].name, names[i].c_str(), names[i].size());
+        entries[i].offset = SDL_SwapLE64(offset);
+        entries[i].size = SDL_SwapLE64(contents[i].size());
+
+        offset += contents[i].size();
+    }
+
+    AssetPackHeader header;
+    memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+    header.version = SDL_SwapLE32(ASSET_PACK_VERSION);
+    header.entriesCount = SDL_SwapLE32(entries.size());
+    header.reserved = 0;
+
+    std::ofstream packFile(packFilePath, std::ios::binary);
+
+    if (!packFile.is_open())
+    {
+        printf("Failed to write %s\n", packFilePath);
+        return false;
+    }
+
+    packFile.write((const char *)&header, sizeof(header));
+    packFile.write((const char *)entries.data(), entries.size() * sizeof(AssetPackEntry));
+
+    for (std::string &content : contents)
+    {
+        packFile.write(content.data(), content.size());
+    }
+
+    return packFile.good();
+}
+
+bool openAssetPack(AssetPack &pack, const char *packFilePath)
+{
+    pack = AssetPack{};
+
+    if (!mapFile(pack.file, packFilePath))
+    {
+        return false;
+    }
+
+    const AssetPackHeader *header = (const AssetPackHeader *)pack.file.data;
+
+    bool isValid = pack.file.size >= sizeof(AssetPackHeader) && memcmp(header->magic, ASSET_PACK_MAGIC, sizeof(header->magic)) == 0;
+
+    if (isValid && SDL_SwapLE32(header->version) != ASSET_PACK_VERSION)
+    {
+        printf("%s is version %u, expected version %u\n", packFilePath, SDL_SwapLE32(header->version), ASSET_PACK_VERSION);
+        isValid = false;
+    }
+
+    if (isValid)
+    {
+        pack.entriesCount = SDL_SwapLE32(header->entriesCount);
+        pack.entries = (const AssetPackEntry *)(pack.file.data + sizeof(AssetPackHeader));
+
+        isValid = sizeof(AssetPackHeader) + (Uint64)pack.entriesCount * sizeof(AssetPackEntry) <= pack.file.size;
+
+        for (Uint32 i = 0; i < pack.entriesCount && isValid; i++)
+        {
+            Uint64 offset = SDL_SwapLE64(pack.entries[i].offset);
+            Uint64 size = SDL_SwapLE64(pack.entries[i].size);
+
+            isValid = offset <= pack.file.size && size <= pack.file.size - offset && pack.entries[i].name[ASSET_PACK_NAME_SIZE - 1] == '\0';
+
+            // findAssetPackEntry() binary searches the names, an unsorted or duplicated one would make lookups miss.
+            isValid = isValid && (i == 0 || strcmp(pack.entries[i - 1].name, pack.entries[i].name) < 0);
+        }
+    }
+
+    if (!isValid)
+    {
+        printf("%s is not a valid asset pack\n", packFilePath);
+        closeAssetPack(pack);
+        return false;
+    }
+
+    return true;
+}
+
+void closeAssetPack(AssetPack &pack)
+{
+    unmapFile(pack.file);
+
+    pack = AssetPack{};
+}
+
+const AssetPackEntry *findAssetPackEntry(const AssetPack &pack, const char *name)
+{
+    const AssetPackEntry *entry = std::lower_bound(pack.entries, pack.entries + pack.entriesCount, name, [](const AssetPackEntry &entry, const char *name)
+                                                   { return strcmp(entry.name, name) < 0; });
+
+    if (entry == pack.entries + pack.entriesCount || strcmp(entry->name, name) != 0)
+    {
+        return nullptr;
+    }
+
+    return entry;
+}
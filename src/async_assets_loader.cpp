@@ -0,0 +1,173 @@
+#include "async_assets_loader.h"
+#include "texture_cache.h"
+#include <cstring>
+
+int addAssetRequest(AsyncAssetsLoader &loader, const char *filePath, AssetType type)
+{
+    loader.requests.push_back({filePath, type, nullptr, nullptr, 0});
+
+    return loader.requests.size() - 1;
+}
+
+void decodeImageRequest(AssetRequest &request)
+{
+    request.surface = loadCachedImage(request.filePath);
+}
+
+void decodeSoundRequest(AssetRequest &request, const AsyncAssetsLoader &loader)
+{
+    SDL_AudioSpec spec;
+    Uint8 *wavBuffer = nullptr;
+    Uint32 wavLength = 0;
+
+    if (SDL_LoadWAV_RW(openAsset(request.filePath), 1, &spec, &wavBuffer, &wavLength) == nullptr)
+    {
+        printf("Failed to load %s! SDL Error: %s\n", request.filePath, SDL_GetError());
+        return;
+    }
+
+    SDL_AudioCVT converter;
+    int conversion = SDL_BuildAudioCVT(&converter, spec.format, spec.channels, spec.freq, loader.mixerFormat, loader.mixerChannels, loader.mixerFrequency);
+
+    if (conversion < 0)
+    {
+        printf("Failed to convert %s! SDL Error: %s\n", request.filePath, SDL_GetError());
+        SDL_FreeWAV(wavBuffer);
+        return;
+    }
+
+    converter.len = wavLength;
+    converter.buf = (Uint8 *)SDL_malloc(wavLength * converter.len_mult);
+    memcpy(converter.buf, wavBuffer, wavLength);
+
+    SDL_FreeWAV(wavBuffer);
+
+    // 0 means the file is already in the mixer format.
+    if (conversion > 0)
+    {
+        SDL_ConvertAudio(&converter);
+    }
+    else
+    {
+        converter.len_cvt = wavLength;
+    }
+
+    request.samples = converter.buf;
+    request.samplesLength = converter.len_cvt;
+}
+
+int runAssetsWorker(void *data)
+{
+    AsyncAssetsLoader &loader = *(AsyncAssetsLoader *)data;
+
+    int requestsCount = loader.requests.size();
+    int requestIndex;
+
+    while ((requestIndex = SDL_AtomicAdd(&loader.nextRequest, 1)) < requestsCount)
+    {
+        AssetRequest &request = loader.requests[requestIndex];
+
+        if (request.type == ASSET_IMAGE)
+        {
+            decodeImageRequest(request);
+        }
+        else
+        {
+            decodeSoundRequest(request, loader);
+        }
+
+        SDL_AtomicAdd(&loader.completedRequests, 1);
+    }
+
+    return 0;
+}
+
+void startAsyncAssetsLoader(AsyncAssetsLoader &loader, int workersCount)
+{
+    if (workersCount <= 0)
+    {
+        workersCount = SDL_GetCPUCount();
+    }
+
+    // never more workers than files.
+    workersCount = SDL_max(1, SDL_min(workersCount, (int)loader.requests.size()));
+
+    SDL_AtomicSet(&loader.nextRequest, 0);
+    SDL_AtomicSet(&loader.completedRequests, 0);
+
+    if (Mix_QuerySpec(&loader.mixerFrequency, &loader.mixerFormat, &loader.mixerChannels) == 0)
+    {
+        loader.mixerFrequency = MIX_DEFAULT_FREQUENCY;
+        loader.mixerFormat = MIX_DEFAULT_FORMAT;
+        loader.mixerChannels = MIX_DEFAULT_CHANNELS;
+    }
+
+    for (int i = 0; i < workersCount; i++)
+    {
+        SDL_Thread *worker = SDL_CreateThread(runAssetsWorker, "assets worker", &loader);
+
+        // without threads the main thread decodes everything itself.
+        if (worker == nullptr)
+        {
+            runAssetsWorker(&loader);
+            break;
+        }
+
+        loader.workers.push_back(worker);
+    }
+}
+
+float getAsyncAssetsLoaderProgress(AsyncAssetsLoader &loader)
+{
+    if (loader.requests.empty())
+    {
+        return 1;
+    }
+
+    return (float)SDL_AtomicGet(&loader.completedRequests) / loader.requests.size();
+}
+
+bool isAsyncAssetsLoaderDone(AsyncAssetsLoader &loader)
+{
+    return SDL_AtomicGet(&loader.completedRequests) == (int)loader.requests.size();
+}
+
+void finishAsyncAssetsLoader(AsyncAssetsLoader &loader)
+{
+    for (SDL_Thread *worker : loader.workers)
+    {
+        SDL_WaitThread(worker, NULL);
+    }
+
+    loader.workers.clear();
+}
+
+Mix_Chunk *createSoundChunk(const AssetRequest &request)
+{
+    if (request.samples == nullptr)
+    {
+        return nullptr;
+    }
+
+    Mix_Chunk *sound = Mix_QuickLoad_RAW(request.samples, request.samplesLength);
+
+    if (sound == nullptr)
+    {
+        printf("Failed to load %s! SDL_mixer Error: %s\n", request.filePath, Mix_GetError());
+    }
+
+    return sound;
+}
+
+void freeAsyncAssetsLoader(AsyncAssetsLoader &loader)
+{
+    finishAsyncAssetsLoader(loader);
+
+    for (AssetRequest &request : loader.requests)
+    {
+        SDL_FreeSurface(request.surface);
+        SDL_free(request.samples);
+    }
+
+    loader.requests.clear();
+}
@@ -0,0 +1,219 @@
+#include "audio_engine.h"
+#include <SDL2/SDL_mixer.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// adds source into destination, clamping to the 16 bit range instead of wrapping around.
+void mixSamples(Sint16 *destination, const Sint16 *source, int samplesCount)
+{
+    int i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64)
+    for (; i + 8 <= samplesCount; i += 8)
+    {
+        __m128i mixed = _mm_loadu_si128((const __m128i *)(destination + i));
+        __m128i samples = _mm_loadu_si128((const __m128i *)(source + i));
+
+        _mm_storeu_si128((__m128i *)(destination + i), _mm_adds_epi16(mixed, samples));
+    }
+#endif
+
+    for (; i < samplesCount; i++)
+    {
+        int mixed = destination[i] + source[i];
+
+        destination[i] = (Sint16)SDL_clamp(mixed, SDL_MIN_SINT16, SDL_MAX_SINT16);
+    }
+}
+
+void startVoice(AudioEngine &engine, const QueuedEvent &request, Uint64 callbackCounter)
+{
+    const EngineSound &sound = engine.sounds[request.code];
+
+    EngineVoice *chosenVoice = nullptr;
+
+    for (int i = 0; i < engine.voicesLimit; i++)
+    {
+        EngineVoice &voice = engine.voices[i];
+
+        if (voice.sound < 0)
+        {
+            chosenVoice = &voice;
+            break;
+        }
+
+        // the least important voice, and the oldest among those.
+        int priority = engine.sounds[voice.sound].priority;
+
+        if (priority <= sound.priority &&
+            (chosenVoice == nullptr || priority < engine.sounds[chosenVoice->sound].priority ||
+             (priority == engine.sounds[chosenVoice->sound].priority && voice.startOrder < chosenVoice->startOrder)))
+        {
+            chosenVoice = &voice;
+        }
+    }
+
+    if (chosenVoice == nullptr)
+    {
+        engine.droppedSounds++;
+        return;
+    }
+
+    *chosenVoice = {request.code, 0, engine.startedVoices++};
+
+    if (engine.isMeasuringLatency && request.inputCounter != 0)
+    {
+        double bufferSeconds = (double)engine.spec.samples / engine.spec.freq;
+        // a sound pushed while the callback was draining the queue only waited for its input.
+        Uint64 waitedCounter = callbackCounter > request.inputCounter ? callbackCounter - request.inputCounter : 0;
+        double latency = (double)waitedCounter / SDL_GetPerformanceFrequency() + bufferSeconds;
+
+        engine.measuredSounds++;
+        engine.latencySum += latency;
+        engine.maxLatency = std::max(engine.maxLatency, latency);
+    }
+}
+
+void mixAudioEngine(void *userdata, Uint8 *stream, int length)
+{
+    AudioEngine &engine = *(AudioEngine *)userdata;
+
+    Uint64 callbackCounter = SDL_GetPerformanceCounter();
+
+    QueuedEvent request;
+
+    while (popQueuedEvent(engine.requests, request))
+    {
+        startVoice(engine, request, callbackCounter);
+    }
+
+    memset(stream, 0, length);
+
+    Sint16 *output = (Sint16 *)stream;
+    Uint32 framesCount = length / (sizeof(Sint16) * engine.spec.channels);
+
+    for (int i = 0; i < engine.voicesLimit; i++)
+    {
+        EngineVoice &voice = engine.voices[i];
+
+        if (voice.sound < 0)
+        {
+            continue;
+        }
+
+        const EngineSound &sound = engine.sounds[voice.sound];
+
+        Uint32 mixedFrames = std::min(framesCount, sound.framesCount - voice.position);
+        const Sint16 *samples = engine.samples.data() + sound.offset + voice.position * engine.spec.channels;
+
+        mixSamples(output, samples, mixedFrames * engine.spec.channels);
+
+        voice.position += mixedFrames;
+
+        if (voice.position >= sound.framesCount)
+        {
+            voice.sound = -1;
+        }
+    }
+}
+
+bool openAudioEngine(AudioEngine &engine, int bufferFrames, int voicesLimit)
+{
+    engine.device = 0;
+    engine.samples.clear();
+    engine.sounds.clear();
+    engine.voicesLimit = SDL_clamp(voicesLimit, 1, AUDIO_ENGINE_MAX_VOICES);
+    engine.startedVoices = 0;
+    engine.droppedSounds = 0;
+    engine.measuredSounds = 0;
+    engine.latencySum = 0;
+    engine.maxLatency = 0;
+
+    // isMeasuringLatency is left as the caller set it.
+    initEventQueue(engine.requests);
+
+    for (EngineVoice &voice : engine.voices)
+    {
+        voice.sound = -1;
+    }
+
+    SDL_AudioSpec desiredSpec = {};
+    desiredSpec.freq = MIX_DEFAULT_FREQUENCY;
+    desiredSpec.format = AUDIO_S16SYS;
+    desiredSpec.channels = MIX_DEFAULT_CHANNELS;
+    desiredSpec.samples = bufferFrames;
+    desiredSpec.callback = mixAudioEngine;
+    desiredSpec.userdata = &engine;
+
+    // the buffer size may change, SDL converts anything else to the format the sounds are in.
+    engine.device = SDL_OpenAudioDevice(NULL, 0, &desiredSpec, &engine.spec, SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
+
+    if (engine.device == 0)
+    {
+        printf("Failed to open the audio device! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+
+    return true;
+}
+
+int addEngineSound(AudioEngine &engine, const Uint8 *samples, Uint32 samplesLength, int priority)
+{
+    if (engine.device == 0 || samples == nullptr)
+    {
+        return -1;
+    }
+
+    Uint32 samplesCount = samplesLength / sizeof(Sint16);
+    Uint32 offset = engine.samples.size();
+
+    engine.samples.resize(offset + samplesCount);
+    memcpy(engine.samples.data() + offset, samples, samplesCount * sizeof(Sint16));
+
+    engine.sounds.push_back({offset, samplesCount / engine.spec.channels, priority});
+
+    return engine.sounds.size() - 1;
+}
+
+void startAudioEngine(AudioEngine &engine)
+{
+    if (engine.device != 0)
+    {
+        SDL_PauseAudioDevice(engine.device, 0);
+    }
+}
+
+void playEngineSound(AudioEngine &engine, int sound, Uint64 inputCounter)
+{
+    if (engine.device == 0 || sound < 0)
+    {
+        return;
+    }
+
+    pushQueuedEvent(engine.requests, sound, inputCounter);
+}
+
+void closeAudioEngine(AudioEngine &engine)
+{
+    if (engine.device != 0)
+    {
+        SDL_CloseAudioDevice(engine.device);
+        engine.device = 0;
+    }
+}
+
+void printAudioEngineStats(const AudioEngine &engine)
+{
+    std::cout << "audio buffer: " << engine.spec.samples << " frames, " << engine.spec.samples * 1000.0 / engine.spec.freq << " ms\n";
+    std::cout << "sounds played: " << engine.startedVoices << ", dropped: " << engine.droppedSounds << "\n";
+
+    if (engine.measuredSounds > 0)
+    {
+        std::cout << "input to audio latency avg: " << engine.latencySum * 1000 / engine.measuredSounds << " ms, max: " << engine.maxLatency * 1000 << " ms" << std::endl;
+    }
+}
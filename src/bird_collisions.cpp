@@ -0,0 +1,369 @@
+#include "bird_collisions.h"
+#include "random_generator.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#define BIRD_COLLISIONS_X86
+#endif
+
+// gcc and clang only emit the wider instructions in functions that ask for them, msvc always does.
+#if defined(BIRD_COLLISIONS_X86) && defined(__GNUC__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#define TARGET_AVX512
+#endif
+
+// written once by initBirdCollisions() before any thread tests birds, only read after that.
+static BirdCollisionKernel selectedKernel = COLLISION_KERNEL_SCALAR;
+
+static inline Uint8 isBirdColliding(float previousY, float y, const BirdCollisionBounds &bounds)
+{
+    int birdTop = (int)y;
+
+    bool isAboveScreen = previousY < bounds.ceiling;
+    bool isOnGround = birdTop + bounds.birdHeightPixels > bounds.groundTop && birdTop < bounds.groundBottom;
+    bool isOutsideOpening = y < bounds.openingTop || y + bounds.birdHeight > bounds.openingBottom;
+
+    return isAboveScreen || isOnGround || isOutsideOpening;
+}
+
+void testBirdCollisionsScalar(const float *previousY, const float *y, int begin, int count, const BirdCollisionBounds &bounds, Uint8 *isDying)
+{
+    for (int i = begin; i < count; i++)
+    {
+        isDying[i] = isBirdColliding(previousY[i], y[i], bounds);
+    }
+}
+
+#ifdef BIRD_COLLISIONS_X86
+
+TARGET_SSE2 void testBirdCollisionsSSE2(const float *previousY, const float *y, int count, const BirdCollisionBounds &bounds, Uint8 *isDying)
+{
+    __m128 ceilings = _mm_set1_ps(bounds.ceiling);
+    __m128 openingTops = _mm_set1_ps(bounds.openingTop);
+    __m128 openingBottoms = _mm_set1_ps(bounds.openingBottom);
+    __m128 birdHeights = _mm_set1_ps(bounds.birdHeight);
+    __m128i groundTops = _mm_set1_epi32(bounds.groundTop);
+    __m128i groundBottoms = _mm_set1_epi32(bounds.groundBottom);
+    __m128i birdHeightsPixels = _mm_set1_epi32(bounds.birdHeightPixels);
+    __m128i ones = _mm_set1_epi8(1);
+
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 previousBirdY = _mm_loadu_ps(previousY + i);
+        __m128 birdY = _mm_loadu_ps(y + i);
+
+        __m128 isAboveScreen = _mm_cmplt_ps(previousBirdY, ceilings);
+        __m128 isOutsideOpening = _mm_or_ps(_mm_cmplt_ps(birdY, openingTops), _mm_cmpgt_ps(_mm_add_ps(birdY, birdHeights), openingBottoms));
+
+        // truncated toward zero, like the cast to int.
+        __m128i birdTops = _mm_cvttps_epi32(birdY);
+        __m128i isOnGround = _mm_and_si128(_mm_cmpgt_epi32(_mm_add_epi32(birdTops, birdHeightsPixels), groundTops),
+                                           _mm_cmplt_epi32(birdTops, groundBottoms));
+
+        __m128i collisions = _mm_or_si128(_mm_castps_si128(_mm_or_ps(isAboveScreen, isOutsideOpening)), isOnGround);
+
+        // all bits set lanes narrowed to one byte each, then masked down to 1.
+        __m128i narrowed = _mm_packs_epi16(_mm_packs_epi32(collisions, collisions), collisions);
+        int bytes = _mm_cvtsi128_si32(_mm_and_si128(narrowed, ones));
+
+        memcpy(isDying + i, &bytes, 4);
+    }
+
+    testBirdCollisionsScalar(previousY, y, i, count, bounds, isDying);
+}
+
+TARGET_AVX2 void testBirdCollisionsAVX2(const float *previousY, const float *y, int count, const BirdCollisionBounds &bounds, Uint8 *isDying)
+{
+    __m256 ceilings = _mm256_set1_ps(bounds.ceiling);
+    __m256 openingTops = _mm256_set1_ps(bounds.openingTop);
+    __m256 openingBottoms = _mm256_set1_ps(bounds.openingBottom);
+    __m256 birdHeights = _mm256_set1_ps(bounds.birdHeight);
+    __m256i groundTops = _mm256_set1_epi32(bounds.groundTop);
+    __m256i groundBottoms = _mm256_set1_epi32(bounds.groundBottom);
+    __m256i birdHeightsPixels = _mm256_set1_epi32(bounds.birdHeightPixels);
+    __m128i ones = _mm_set1_epi8(1);
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 previousBirdY = _mm256_loadu_ps(previousY + i);
+        __m256 birdY = _mm256_loadu_ps(y + i);
+
+        __m256 isAboveScreen = _mm256_cmp_ps(previousBirdY, ceilings, _CMP_LT_OQ);
+        __m256 isOutsideOpening = _mm256_or_ps(_mm256_cmp_ps(birdY, openingTops, _CMP_LT_OQ),
+                                               _mm256_cmp_ps(_mm256_add_ps(birdY, birdHeights), openingBottoms, _CMP_GT_OQ));
+
+        __m256i birdTops = _mm256_cvttps_epi32(birdY);
+        __m256i isOnGround = _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_add_epi32(birdTops, birdHeightsPixels), groundTops),
+                                              _mm256_cmpgt_epi32(groundBottoms, birdTops));
+
+        __m256i collisions = _mm256_or_si256(_mm256_castps_si256(_mm256_or_ps(isAboveScreen, isOutsideOpening)), isOnGround);
+
+        // the packs work within each 128 bit half, so the halves are narrowed together.
+        __m128i low = _mm256_castsi256_si128(collisions);
+        __m128i high = _mm256_extracti128_si256(collisions, 1);
+        __m128i narrowed = _mm_packs_epi16(_mm_packs_epi32(low, high), low);
+
+        _mm_storel_epi64((__m128i *)(isDying + i), _mm_and_si128(narrowed, ones));
+    }
+
+    testBirdCollisionsScalar(previousY, y, i, count, bounds, isDying);
+}
+
+TARGET_AVX512 void testBirdCollisionsAVX512(const float *previousY, const float *y, int count, const BirdCollisionBounds &bounds,
+                                            Uint8 *isDying)
+{
+    __m512 ceilings = _mm512_set1_ps(bounds.ceiling);
+    __m512 openingTops = _mm512_set1_ps(bounds.openingTop);
+    __m512 openingBottoms = _mm512_set1_ps(bounds.openingBottom);
+    __m512 birdHeights = _mm512_set1_ps(bounds.birdHeight);
+    __m512i groundTops = _mm512_set1_epi32(bounds.groundTop);
+    __m512i groundBottoms = _mm512_set1_epi32(bounds.groundBottom);
+    __m512i birdHeightsPixels = _mm512_set1_epi32(bounds.birdHeightPixels);
+
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m512 previousBirdY = _mm512_loadu_ps(previousY + i);
+        __m512 birdY = _mm512_loadu_ps(y + i);
+
+        __mmask16 collisions = _mm512_cmp_ps_mask(previousBirdY, ceilings, _CMP_LT_OQ);
+        collisions |= _mm512_cmp_ps_mask(birdY, openingTops, _CMP_LT_OQ);
+        collisions |= _mm512_cmp_ps_mask(_mm512_add_ps(birdY, birdHeights), openingBottoms, _CMP_GT_OQ);
+
+        __m512i birdTops = _mm512_cvttps_epi32(birdY);
+        collisions |= _mm512_cmpgt_epi32_mask(_mm512_add_epi32(birdTops, birdHeightsPixels), groundTops) &
+                      _mm512_cmplt_epi32_mask(birdTops, groundBottoms);
+
+        _mm_storeu_si128((__m128i *)(isDying + i), _mm512_cvtepi32_epi8(_mm512_maskz_set1_epi32(collisions, 1)));
+    }
+
+    testBirdCollisionsScalar(previousY, y, i, count, bounds, isDying);
+}
+
+#endif
+
+bool isBirdCollisionKernelSupported(BirdCollisionKernel kernel)
+{
+    switch (kernel)
+    {
+    case COLLISION_KERNEL_SCALAR:
+        return true;
+#ifdef BIRD_COLLISIONS_X86
+    case COLLISION_KERNEL_SSE2:
+        return SDL_HasSSE2();
+    case COLLISION_KERNEL_AVX2:
+        return SDL_HasAVX2();
+    case COLLISION_KERNEL_AVX512:
+        return SDL_HasAVX512F();
+#endif
+    default:
+        return false;
+    }
+}
+
+void initBirdCollisions()
+{
+    selectedKernel = COLLISION_KERNEL_SCALAR;
+
+    for (int kernel = COLLISION_KERNEL_COUNT - 1; kernel > COLLISION_KERNEL_SCALAR; kernel--)
+    {
+        if (isBirdCollisionKernelSupported((BirdCollisionKernel)kernel))
+        {
+            selectedKernel = (BirdCollisionKernel)kernel;
+            break;
+        }
+    }
+}
+
+BirdCollisionKernel getBirdCollisionKernel()
+{
+    return selectedKernel;
+}
+
+const char *getBirdCollisionKernelName(BirdCollisionKernel kernel)
+{
+    switch (kernel)
+    {
+    case COLLISION_KERNEL_SCALAR:
+        return "scalar";
+    case COLLISION_KERNEL_SSE2:
+        return "sse2";
+    case COLLISION_KERNEL_AVX2:
+        return "avx2";
+    case COLLISION_KERNEL_AVX512:
+        return "avx512";
+    default:
+        return "unknown";
+    }
+}
+
+void testBirdCollisionsWith(BirdCollisionKernel kernel, const float *previousY, const float *y, int count, const BirdCollisionBounds &bounds,
+                            Uint8 *isDying)
+{
+    switch (kernel)
+    {
+#ifdef BIRD_COLLISIONS_X86
+    case COLLISION_KERNEL_SSE2:
+        testBirdCollisionsSSE2(previousY, y, count, bounds, isDying);
+        break;
+    case COLLISION_KERNEL_AVX2:
+        testBirdCollisionsAVX2(previousY, y, count, bounds, isDying);
+        break;
+    case COLLISION_KERNEL_AVX512:
+        testBirdCollisionsAVX512(previousY, y, count, bounds, isDying);
+        break;
+#endif
+    default:
+        testBirdCollisionsScalar(previousY, y, 0, count, bounds, isDying);
+        break;
+    }
+}
+
+void testBirdCollisions(const float *previousY, const float *y, int count, const BirdCollisionBounds &bounds, Uint8 *isDying)
+{
+    testBirdCollisionsWith(getBirdCollisionKernel(), previousY, y, count, bounds, isDying);
+}
+
+// random heights over the whole screen, plus every bound itself and the floats right next to it.
+void makeCheckBirds(RandomGenerator &random, const BirdCollisionBounds &bounds, std::vector<float> &previousY, std::vector<float> &y)
+{
+    const float edges[] = {bounds.ceiling,
+                           (float)bounds.groundTop - bounds.birdHeightPixels,
+                           (float)bounds.groundTop - bounds.birdHeightPixels + 1,
+                           (float)bounds.groundBottom,
+                           bounds.openingTop,
+                           bounds.openingBottom - bounds.birdHeight,
+                           0,
+                           -0.5f};
+
+    previousY.clear();
+    y.clear();
+
+    for (float edge : edges)
+    {
+        for (float value : {std::nextafter(edge, -INFINITY), edge, std::nextafter(edge, INFINITY)})
+        {
+            previousY.push_back(value);
+            y.push_back(value);
+        }
+    }
+
+    float lowest = bounds.ceiling * 2;
+    float range = bounds.groundBottom - lowest;
+
+    // an odd count so every kernel also runs its scalar tail.
+    while (y.size() < 4099)
+    {
+        previousY.push_back(lowest + nextRandomFloat(random) * range);
+        y.push_back(lowest + nextRandomFloat(random) * range);
+    }
+}
+
+bool checkBirdCollisionKernels()
+{
+    RandomGenerator random;
+    seedRandomGenerator(random, 1);
+
+    std::vector<float> previousY;
+    std::vector<float> y;
+    std::vector<Uint8> expected;
+    std::vector<Uint8> actual;
+
+    bool isMatching = true;
+
+    for (int round = 0; round < 64; round++)
+    {
+        // the sizes of the game's bird and ground, with a pipe in the column every other round.
+        BirdCollisionBounds bounds = {-24, 432, 544, -544, 1088, 24, 24};
+
+        if (round % 2 == 1)
+        {
+            float gapCenter = 150 + nextRandomFloat(random) * 220;
+
+            bounds.openingTop = gapCenter - 40;
+            bounds.openingBottom = gapCenter + 40;
+        }
+
+        makeCheckBirds(random, bounds, previousY, y);
+
+        expected.assign(y.size(), 2);
+        testBirdCollisionsWith(COLLISION_KERNEL_SCALAR, previousY.data(), y.data(), y.size(), bounds, expected.data());
+
+        for (int kernel = COLLISION_KERNEL_SCALAR + 1; kernel < COLLISION_KERNEL_COUNT; kernel++)
+        {
+            if (!isBirdCollisionKernelSupported((BirdCollisionKernel)kernel))
+            {
+                continue;
+            }
+
+            actual.assign(y.size(), 2);
+            testBirdCollisionsWith((BirdCollisionKernel)kernel, previousY.data(), y.data(), y.size(), bounds, actual.data());
+
+            for (size_t i = 0; i < y.size(); i++)
+            {
+                if (actual[i] != expected[i])
+                {
+                    printf("%s: bird %d at %.9g from %.9g is %d instead of %d\n", getBirdCollisionKernelName((BirdCollisionKernel)kernel), (int)i,
+                           y[i], previousY[i], actual[i], expected[i]);
+                    isMatching = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    printf("collision kernels %s the scalar one\n", isMatching ? "match" : "don't match");
+
+    const int birdsCount = 16384;
+    const int repeats = 2000;
+
+    BirdCollisionBounds bounds = {-24, 432, 544, 200, 280, 24, 24};
+    previousY.resize(birdsCount);
+    y.resize(birdsCount);
+    actual.resize(birdsCount);
+
+    for (int i = 0; i < birdsCount; i++)
+    {
+        previousY[i] = nextRandomFloat(random) * 500;
+        y[i] = nextRandomFloat(random) * 500;
+    }
+
+    for (int kernel = COLLISION_KERNEL_SCALAR; kernel < COLLISION_KERNEL_COUNT; kernel++)
+    {
+        if (!isBirdCollisionKernelSupported((BirdCollisionKernel)kernel))
+        {
+            printf("%s: not supported by this cpu\n", getBirdCollisionKernelName((BirdCollisionKernel)kernel));
+            continue;
+        }
+
+        Uint64 startCounter = SDL_GetPerformanceCounter();
+
+        for (int repeat = 0; repeat < repeats; repeat++)
+        {
+            testBirdCollisionsWith((BirdCollisionKernel)kernel, previousY.data(), y.data(), birdsCount, bounds, actual.data());
+        }
+
+        double elapsedSeconds = (double)(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
+
+        printf("%s: %.0f million birds per second\n", getBirdCollisionKernelName((BirdCollisionKernel)kernel),
+               elapsedSeconds > 0 ? (double)birdsCount * repeats / elapsedSeconds / 1000000 : 0);
+    }
+
+    printf("selected kernel: %s\n", getBirdCollisionKernelName(getBirdCollisionKernel()));
+
+    return isMatching;
+}
@@ -0,0 +1,217 @@
+#include "bird_flock.h"
+#include "bird_collisions.h"
+#include <algorithm>
+
+void initBirdFlock(BirdFlock &flock, const GameDimensions &dimensions, int birdsCount, Uint64 seed)
+{
+    flock.dimensions = dimensions;
+    flock.groundCollisionBounds = {0, SCREEN_HEIGHT - dimensions.groundHeight, SCREEN_WIDTH, dimensions.groundHeight};
+    flock.impulse = -10000;
+    flock.gravityIncrement = 400;
+
+    initPipeCourse(flock.pipeCourse, seed, dimensions.pipeHeight + PIPE_GAP_HEIGHT / 2, 220, PIPE_GAP_HEIGHT);
+
+    flock.birdsCount = birdsCount;
+
+    flock.y.resize(birdsCount);
+    flock.previousY.resize(birdsCount);
+    flock.speed.resize(birdsCount);
+    flock.angle.resize(birdsCount);
+    flock.previousAngle.resize(birdsCount);
+    flock.downRotationTimer.resize(birdsCount);
+    flock.isDying.resize(birdsCount);
+    flock.birdIds.resize(birdsCount);
+
+    flock.isAlive.resize(birdsCount);
+    flock.scores.resize(birdsCount);
+    flock.deathTicks.resize(birdsCount);
+    flock.deathY.resize(birdsCount);
+
+    resetBirdFlock(flock);
+}
+
+void resetBirdFlock(BirdFlock &flock)
+{
+    clearPipePairs(flock.pipes);
+    restartPipeCourse(flock.pipeCourse);
+    flock.distanceSinceLastPipe = 0;
+
+    for (int i = 0; i < GROUND_TILES_COUNT; i++)
+    {
+        flock.groundPositions[i] = {(float)flock.dimensions.groundWidth * i, (float)flock.groundCollisionBounds.y};
+        flock.previousGroundPositions[i] = flock.groundPositions[i];
+    }
+
+    flock.startGameTimer = 0;
+    flock.score = 0;
+    flock.tick = 0;
+    flock.aliveCount = flock.birdsCount;
+
+    for (int i = 0; i < flock.birdsCount; i++)
+    {
+        flock.y[i] = SCREEN_HEIGHT / 2;
+        flock.previousY[i] = flock.y[i];
+        flock.speed[i] = 0;
+        flock.angle[i] = 0;
+        flock.previousAngle[i] = 0;
+        flock.downRotationTimer[i] = 0;
+        flock.birdIds[i] = i;
+
+        flock.isAlive[i] = 1;
+        flock.scores[i] = 0;
+        flock.deathTicks[i] = 0;
+        flock.deathY[i] = 0;
+    }
+}
+
+void scrollFlockWorld(BirdFlock &flock, float deltaTime)
+{
+    flock.startGameTimer += deltaTime;
+
+    flock.distanceSinceLastPipe += SCROLL_SPEED * deltaTime;
+
+    if (flock.distanceSinceLastPipe >= PIPE_SPACING)
+    {
+        PipeLayout layout = nextPipeLayout(flock.pipeCourse);
+
+        flock.distanceSinceLastPipe -= PIPE_SPACING;
+        pushPipePair(flock.pipes, SCREEN_WIDTH - flock.distanceSinceLastPipe, layout.gapCenter, layout.gapHeight);
+    }
+
+    for (Vector2 &groundPosition : flock.groundPositions)
+    {
+        groundPosition.x -= SCROLL_SPEED * deltaTime;
+
+        if (groundPosition.x < -flock.dimensions.groundWidth)
+        {
+            groundPosition.x = flock.dimensions.groundWidth * (GROUND_TILES_COUNT - 1);
+        }
+    }
+}
+
+// swaps the dying birds out of the living slots, the order of the living isn't kept.
+int removeDyingBirds(BirdFlock &flock)
+{
+    int diedCount = 0;
+    int slot = 0;
+
+    while (slot < flock.aliveCount)
+    {
+        if (!flock.isDying[slot])
+        {
+            slot++;
+            continue;
+        }
+
+        int birdId = flock.birdIds[slot];
+        flock.isAlive[birdId] = 0;
+        flock.scores[birdId] = flock.score;
+        flock.deathTicks[birdId] = flock.tick;
+        flock.deathY[birdId] = flock.y[slot];
+        diedCount++;
+
+        int last = --flock.aliveCount;
+
+        flock.y[slot] = flock.y[last];
+        flock.previousY[slot] = flock.previousY[last];
+        flock.speed[slot] = flock.speed[last];
+        flock.angle[slot] = flock.angle[last];
+        flock.previousAngle[slot] = flock.previousAngle[last];
+        flock.downRotationTimer[slot] = flock.downRotationTimer[last];
+        flock.isDying[slot] = flock.isDying[last];
+        flock.birdIds[slot] = flock.birdIds[last];
+    }
+
+    return diedCount;
+}
+
+int stepBirdFlock(BirdFlock &flock, const Uint8 *flaps, float deltaTime)
+{
+    if (flock.aliveCount == 0)
+    {
+        return 0;
+    }
+
+    int aliveCount = flock.aliveCount;
+    float *y = flock.y.data();
+    float *speed = flock.speed.data();
+    float *angle = flock.angle.data();
+    float *downRotationTimer = flock.downRotationTimer.data();
+    Uint8 *isDying = flock.isDying.data();
+
+    // a flap happens before the tick, like an input in the game.
+    float flapSpeed = flock.impulse / FRAME_RATE;
+
+    for (int i = 0; i < aliveCount; i++)
+    {
+        if (flaps[i])
+        {
+            speed[i] = flapSpeed;
+            angle[i] = -20;
+            downRotationTimer[i] = 0;
+        }
+    }
+
+    std::copy(flock.y.begin(), flock.y.begin() + aliveCount, flock.previousY.begin());
+    std::copy(flock.angle.begin(), flock.angle.begin() + aliveCount, flock.previousAngle.begin());
+
+    for (int i = 0; i < GROUND_TILES_COUNT; i++)
+    {
+        flock.previousGroundPositions[i] = flock.groundPositions[i];
+    }
+
+    savePipePairsPositions(flock.pipes);
+
+    flock.tick++;
+
+    scrollFlockWorld(flock, deltaTime);
+
+    float birdX = SCREEN_WIDTH / 2;
+    float birdWidth = flock.dimensions.birdWidth;
+    float birdHeight = flock.dimensions.birdHeight;
+
+    // the pipes move once for the whole flock, the bird only decides which pairs count as passed.
+    SDL_FRect birdBounds = {birdX, SCREEN_HEIGHT / 2, birdWidth, birdHeight};
+    PipePairsStep pipesStep = movePipePairs(flock.pipes, SCROLL_SPEED * deltaTime, birdBounds, flock.dimensions.pipeWidth);
+
+    flock.score += pipesStep.passedPairs;
+
+    // every bird shares the same x, so they all test against the same opening.
+    BirdCollisionBounds collisionBounds;
+    collisionBounds.ceiling = -birdHeight;
+    collisionBounds.groundTop = flock.groundCollisionBounds.y;
+    collisionBounds.groundBottom = flock.groundCollisionBounds.y + flock.groundCollisionBounds.h;
+    collisionBounds.openingTop = -SCREEN_HEIGHT;
+    collisionBounds.openingBottom = 2 * SCREEN_HEIGHT;
+    collisionBounds.birdHeight = birdHeight;
+    collisionBounds.birdHeightPixels = flock.dimensions.birdHeight;
+
+    findPipeOpening(flock.pipes, birdX, birdX + birdWidth, flock.dimensions.pipeWidth, collisionBounds.openingTop,
+                    collisionBounds.openingBottom);
+
+    if (flock.startGameTimer > 1)
+    {
+        float gravityIncrement = flock.gravityIncrement;
+        float fallDistance = 0.5f * gravityIncrement * deltaTime * deltaTime;
+
+        for (int i = 0; i < aliveCount; i++)
+        {
+            y[i] += speed[i] * deltaTime + fallDistance;
+            speed[i] += gravityIncrement * deltaTime;
+
+            downRotationTimer[i] += deltaTime;
+
+            if (downRotationTimer[i] > 0.5f && angle[i] <= 90)
+            {
+                angle[i] += 120 * deltaTime;
+            }
+        }
+    }
+
+    // the ceiling is tested against where the birds were before the tick, like in the game.
+    testBirdCollisions(flock.previousY.data(), y, aliveCount, collisionBounds, isDying);
+
+    removePassedPipePairs(flock.pipes, flock.dimensions.pipeWidth);
+
+    return removeDyingBirds(flock);
+}
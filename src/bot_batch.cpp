@@ -0,0 +1,287 @@
+#include "bot_batch.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#define BOT_BATCH_X86
+#endif
+
+#if defined(BOT_BATCH_X86) && defined(__GNUC__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+// written once by initBotBatchKernel() before any thread runs a batch, only read after that.
+static BotBatchKernel selectedBotBatchKernel = BOT_BATCH_KERNEL_SCALAR;
+
+int getBlockWeightIndex(int slot, int weight)
+{
+    return (slot / BOT_BATCH_LANES) * BOT_WEIGHTS_COUNT * BOT_BATCH_LANES + weight * BOT_BATCH_LANES + slot % BOT_BATCH_LANES;
+}
+
+int getBlockInputIndex(int slot, int input)
+{
+    return (slot / BOT_BATCH_LANES) * BOT_INPUTS_COUNT * BOT_BATCH_LANES + input * BOT_BATCH_LANES + slot % BOT_BATCH_LANES;
+}
+
+void initBotBatch(BotBatch &batch, const BotGenome *genomes, int botsCount)
+{
+    batch.botsCount = botsCount;
+    batch.blocksCount = (botsCount + BOT_BATCH_LANES - 1) / BOT_BATCH_LANES;
+
+    // the lanes past the last bot have all their weights at 0, they never flap.
+    batch.weights.assign(batch.blocksCount * BOT_WEIGHTS_COUNT * BOT_BATCH_LANES, 0);
+    batch.inputs.assign(batch.blocksCount * BOT_INPUTS_COUNT * BOT_BATCH_LANES, 0);
+    batch.flaps.assign(batch.blocksCount * BOT_BATCH_LANES, 0);
+    batch.slotBots.resize(botsCount);
+    batch.botSlots.resize(botsCount);
+
+    for (int slot = 0; slot < botsCount; slot++)
+    {
+        for (int weight = 0; weight < BOT_WEIGHTS_COUNT; weight++)
+        {
+            batch.weights[getBlockWeightIndex(slot, weight)] = genomes[slot].weights[weight];
+        }
+
+        batch.slotBots[slot] = slot;
+        batch.botSlots[slot] = slot;
+    }
+}
+
+void setBotBatchInputs(BotBatch &batch, int slot, const float inputs[BOT_INPUTS_COUNT])
+{
+    for (int input = 0; input < BOT_INPUTS_COUNT; input++)
+    {
+        batch.inputs[getBlockInputIndex(slot, input)] = inputs[input];
+    }
+}
+
+void syncBotBatchSlots(BotBatch &batch, const int *slotBirds, int slotsCount)
+{
+    // a flock moves each surviving bird at most once, from a slot past the new living count into a
+    // freed one, so a slot is never copied from after it was overwritten.
+    for (int slot = 0; slot < slotsCount; slot++)
+    {
+        int bot = slotBirds[slot];
+
+        if (batch.slotBots[slot] == bot)
+        {
+            continue;
+        }
+
+        int previousSlot = batch.botSlots[bot];
+
+        for (int weight = 0; weight < BOT_WEIGHTS_COUNT; weight++)
+        {
+            batch.weights[getBlockWeightIndex(slot, weight)] = batch.weights[getBlockWeightIndex(previousSlot, weight)];
+        }
+
+        batch.slotBots[slot] = bot;
+        batch.botSlots[bot] = slot;
+    }
+}
+
+// the same operations in the same order as isBotFlapping().
+void runBotBatchScalar(BotBatch &batch, int slotsCount)
+{
+    for (int slot = 0; slot < slotsCount; slot++)
+    {
+        const float *weights = batch.weights.data() + getBlockWeightIndex(slot, 0);
+        const float *inputs = batch.inputs.data() + getBlockInputIndex(slot, 0);
+
+        float output = weights[(BOT_OUTPUT_WEIGHTS + BOT_HIDDEN_COUNT) * BOT_BATCH_LANES];
+
+        for (int i = 0; i < BOT_HIDDEN_COUNT; i++)
+        {
+            const float *neuronWeights = weights + i * (BOT_INPUTS_COUNT + 1) * BOT_BATCH_LANES;
+            float sum = neuronWeights[BOT_INPUTS_COUNT * BOT_BATCH_LANES];
+
+            for (int j = 0; j < BOT_INPUTS_COUNT; j++)
+            {
+                sum += neuronWeights[j * BOT_BATCH_LANES] * inputs[j * BOT_BATCH_LANES];
+            }
+
+            output += weights[(BOT_OUTPUT_WEIGHTS + i) * BOT_BATCH_LANES] * approximateTanh(sum);
+        }
+
+        batch.flaps[slot] = output > 0;
+    }
+}
+
+#ifdef BOT_BATCH_X86
+
+// no vector array lives on the stack, mingw doesn't align it to 32 bytes.
+// the same operations in the same order as isBotFlapping(), lane by lane. no fused multiply adds, they round
+// once instead of twice and a bot could decide differently in training than in the game.
+TARGET_AVX2 void runBotBatchAVX2(BotBatch &batch, int slotsCount)
+{
+    const __m256 minimums = _mm256_set1_ps(-3);
+    const __m256 maximums = _mm256_set1_ps(3);
+    const __m256 twentySevens = _mm256_set1_ps(27);
+    const __m256 nines = _mm256_set1_ps(9);
+    const __m256 zeros = _mm256_setzero_ps();
+    const __m128i ones = _mm_set1_epi8(1);
+
+    int blocksCount = (slotsCount + BOT_BATCH_LANES - 1) / BOT_BATCH_LANES;
+
+    for (int block = 0; block < blocksCount; block++)
+    {
+        const float *weights = batch.weights.data() + block * BOT_WEIGHTS_COUNT * BOT_BATCH_LANES;
+        const float *inputs = batch.inputs.data() + block * BOT_INPUTS_COUNT * BOT_BATCH_LANES;
+
+        __m256 outputs = _mm256_loadu_ps(weights + (BOT_OUTPUT_WEIGHTS + BOT_HIDDEN_COUNT) * BOT_BATCH_LANES);
+
+        for (int i = 0; i < BOT_HIDDEN_COUNT; i++)
+        {
+            const float *neuronWeights = weights + i * (BOT_INPUTS_COUNT + 1) * BOT_BATCH_LANES;
+            __m256 sums = _mm256_loadu_ps(neuronWeights + BOT_INPUTS_COUNT * BOT_BATCH_LANES);
+
+            for (int j = 0; j < BOT_INPUTS_COUNT; j++)
+            {
+                sums = _mm256_add_ps(sums, _mm256_mul_ps(_mm256_loadu_ps(neuronWeights + j * BOT_BATCH_LANES), _mm256_loadu_ps(inputs + j * BOT_BATCH_LANES)));
+            }
+
+            __m256 x = _mm256_max_ps(_mm256_min_ps(sums, maximums), minimums);
+            __m256 squared = _mm256_mul_ps(x, x);
+            __m256 numerators = _mm256_mul_ps(x, _mm256_add_ps(twentySevens, squared));
+            __m256 denominators = _mm256_add_ps(twentySevens, _mm256_mul_ps(nines, squared));
+            __m256 activations = _mm256_div_ps(numerators, denominators);
+
+            outputs = _mm256_add_ps(outputs, _mm256_mul_ps(_mm256_loadu_ps(weights + (BOT_OUTPUT_WEIGHTS + i) * BOT_BATCH_LANES), activations));
+        }
+
+        __m256i isFlapping = _mm256_castps_si256(_mm256_cmp_ps(outputs, zeros, _CMP_GT_OQ));
+
+        __m128i low = _mm256_castsi256_si128(isFlapping);
+        __m128i high = _mm256_extracti128_si256(isFlapping, 1);
+        __m128i narrowed = _mm_packs_epi16(_mm_packs_epi32(low, high), low);
+
+        _mm_storel_epi64((__m128i *)(batch.flaps.data() + block * BOT_BATCH_LANES), _mm_and_si128(narrowed, ones));
+    }
+}
+
+#endif
+
+bool isBotBatchKernelSupported(BotBatchKernel kernel)
+{
+    switch (kernel)
+    {
+    case BOT_BATCH_KERNEL_SCALAR:
+        return true;
+#ifdef BOT_BATCH_X86
+    case BOT_BATCH_KERNEL_AVX2:
+        return SDL_HasAVX2();
+#endif
+    default:
+        return false;
+    }
+}
+
+void initBotBatchKernel()
+{
+    selectedBotBatchKernel = isBotBatchKernelSupported(BOT_BATCH_KERNEL_AVX2) ? BOT_BATCH_KERNEL_AVX2 : BOT_BATCH_KERNEL_SCALAR;
+}
+
+BotBatchKernel getBotBatchKernel()
+{
+    return selectedBotBatchKernel;
+}
+
+const char *getBotBatchKernelName(BotBatchKernel kernel)
+{
+    switch (kernel)
+    {
+    case BOT_BATCH_KERNEL_SCALAR:
+        return "scalar";
+    case BOT_BATCH_KERNEL_AVX2:
+        return "avx2";
+    default:
+        return "unknown";
+    }
+}
+
+void runBotBatchWith(BotBatchKernel kernel, BotBatch &batch, int slotsCount)
+{
+    switch (kernel)
+    {
+#ifdef BOT_BATCH_X86
+    case BOT_BATCH_KERNEL_AVX2:
+        runBotBatchAVX2(batch, slotsCount);
+        break;
+#endif
+    default:
+        runBotBatchScalar(batch, slotsCount);
+        break;
+    }
+}
+
+void runBotBatch(BotBatch &batch, int slotsCount)
+{
+    runBotBatchWith(getBotBatchKernel(), batch, slotsCount);
+}
+
+void benchmarkBotBatch(int botsCount)
+{
+    RandomGenerator random;
+    seedRandomGenerator(random, 1);
+
+    std::vector<BotGenome> genomes(botsCount);
+    std::vector<float> inputs(botsCount * BOT_INPUTS_COUNT);
+
+    for (BotGenome &genome : genomes)
+    {
+        for (float &weight : genome.weights)
+        {
+            weight = nextRandomFloat(random) * 2 - 1;
+        }
+    }
+
+    for (float &input : inputs)
+    {
+        input = nextRandomFloat(random) * 2 - 1;
+    }
+
+    BotBatch batch;
+    initBotBatch(batch, genomes.data(), botsCount);
+
+    for (int slot = 0; slot < botsCount; slot++)
+    {
+        setBotBatchInputs(batch, slot, &inputs[slot * BOT_INPUTS_COUNT]);
+    }
+
+    const int repeats = 200;
+
+    for (int kernel = BOT_BATCH_KERNEL_SCALAR; kernel < BOT_BATCH_KERNEL_COUNT; kernel++)
+    {
+        const char *kernelName = getBotBatchKernelName((BotBatchKernel)kernel);
+
+        if (!isBotBatchKernelSupported((BotBatchKernel)kernel))
+        {
+            printf("%s: not supported by this cpu\n", kernelName);
+            continue;
+        }
+
+        Uint64 startCounter = SDL_GetPerformanceCounter();
+
+        for (int repeat = 0; repeat < repeats; repeat++)
+        {
+            runBotBatchWith((BotBatchKernel)kernel, batch, botsCount);
+        }
+
+        double elapsedSeconds = (double)(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
+
+        int matchingDecisions = 0;
+
+        for (int slot = 0; slot < botsCount; slot++)
+        {
+            matchingDecisions += batch.flaps[slot] == isBotFlapping(genomes[slot], &inputs[slot * BOT_INPUTS_COUNT]);
+        }
+
+        printf("%s: %.1f million bots per second, %d of %d decisions match\n", kernelName,
+               elapsedSeconds > 0 ? (double)botsCount * repeats / elapsedSeconds / 1000000 : 0, matchingDecisions, botsCount);
+    }
+
+    printf("selected kernel: %s\n", getBotBatchKernelName(getBotBatchKernel()));
+}
@@ -0,0 +1,387 @@
+#include "bot_trainer.h"
+#include "thread_pool.h"
+#include "bird_flock.h"
+#include "bot_batch.h"
+#include "random_generator.h"
+#include "high_score_writer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+void initBotTrainerSettings(BotTrainerSettings &settings)
+{
+    settings.populationSize = 1000;
+    settings.generationsCount = 50;
+    settings.courseSeed = 1;
+    settings.trainingSeed = 1;
+    settings.tickRate = FRAME_RATE;
+    // 2 minutes of play.
+    settings.maxTicks = FRAME_RATE * 120;
+    settings.elitesCount = 10;
+    settings.mutationRate = 0.1f;
+    settings.mutationStrength = 0.5f;
+    settings.workersCount = 0;
+}
+
+void getBirdBotInputs(const PipePairs &pipes, const GameDimensions &dimensions, float birdY, float speed, float impulse,
+                      float inputs[BOT_INPUTS_COUNT])
+{
+    float birdCenter = birdY + dimensions.birdHeight / 2;
+    float birdX = SCREEN_WIDTH / 2;
+
+    // without pipes ahead the bot aims for the middle of the screen.
+    float nextPipeDistance = PIPE_SPACING;
+    float gapCenters[2] = {SCREEN_HEIGHT / 2, SCREEN_HEIGHT / 2};
+    int gapsFound = 0;
+
+    for (int i = 0; i < pipes.count && gapsFound < 2; i++)
+    {
+        int index = getPipePairIndex(pipes, i);
+        float pipeEnd = pipes.x[index] + dimensions.pipeWidth;
+
+        if (pipeEnd > birdX)
+        {
+            if (gapsFound == 0)
+            {
+                nextPipeDistance = pipeEnd - birdX;
+            }
+
+            gapCenters[gapsFound] = pipes.gapCenter[index];
+            gapsFound++;
+        }
+    }
+
+    inputs[0] = birdY / SCREEN_HEIGHT;
+    // a flap sets the speed to impulse / FRAME_RATE, about -167 pixels per second.
+    inputs[1] = speed * FRAME_RATE / -impulse;
+    inputs[2] = nextPipeDistance / PIPE_SPACING;
+    // in gap heights, a small offset has to be visible to the network.
+    inputs[3] = (gapCenters[0] - birdCenter) / PIPE_GAP_HEIGHT;
+    inputs[4] = (gapCenters[1] - birdCenter) / PIPE_GAP_HEIGHT;
+}
+
+void getBotInputs(const GameState &game, float inputs[BOT_INPUTS_COUNT])
+{
+    getBirdBotInputs(game.pipes, game.dimensions, game.playerY, game.gravity, game.impulse, inputs);
+}
+
+bool isBotFlapping(const BotGenome &genome, const float inputs[BOT_INPUTS_COUNT])
+{
+    const float *weights = genome.weights;
+    const float *outputWeights = genome.weights + BOT_OUTPUT_WEIGHTS;
+
+    float output = outputWeights[BOT_HIDDEN_COUNT];
+
+    for (int i = 0; i < BOT_HIDDEN_COUNT; i++)
+    {
+        float sum = weights[BOT_INPUTS_COUNT];
+
+        for (int j = 0; j < BOT_INPUTS_COUNT; j++)
+        {
+            sum += weights[j] * inputs[j];
+        }
+
+        output += outputWeights[i] * approximateTanh(sum);
+        weights += BOT_INPUTS_COUNT + 1;
+    }
+
+    return output > 0;
+}
+
+bool shouldBotFlap(const BotGenome &genome, const GameState &game)
+{
+    float inputs[BOT_INPUTS_COUNT];
+    getBotInputs(game, inputs);
+
+    return isBotFlapping(genome, inputs);
+}
+
+float getBotFitness(Uint64 ticks, int score, float gapOffset, const BotTrainerSettings &settings)
+{
+    // a pipe is worth as much as the ticks it takes to reach the next one, and among the bots
+    // that crash at the same place the ones closer to the gap rank higher.
+    float ticksPerPipe = PIPE_SPACING / SCROLL_SPEED * settings.tickRate;
+
+    float gapDistance = std::fabs(gapOffset) * PIPE_GAP_HEIGHT;
+
+    return ticks + score * ticksPerPipe - gapDistance / SCREEN_HEIGHT * ticksPerPipe;
+}
+
+typedef struct
+{
+    BotGenome genome;
+    float fitness;
+    int score;
+    Uint64 ticks;
+} BotEvaluation;
+
+// bots evaluated together in one flock, small enough that the flock and its batch stay in the cache
+// and that the thread pool has tasks to balance.
+const int BOT_TRAINER_FLOCK_SIZE = 256;
+
+typedef struct
+{
+    const BotTrainerSettings *settings;
+    GameDimensions dimensions;
+    BotEvaluation *evaluations;
+    int evaluationsCount;
+} BotEvaluationBatch;
+
+// a flock flies the course exactly like a game per bird and the batch decides like shouldBotFlap(), so a bot
+// earns the fitness it would playing the real game alone.
+void evaluateBotFlockTask(void *data, int index)
+{
+    BotEvaluationBatch &batch = *(BotEvaluationBatch *)data;
+    const BotTrainerSettings &settings = *batch.settings;
+
+    BotEvaluation *evaluations = batch.evaluations + index * BOT_TRAINER_FLOCK_SIZE;
+    int botsCount = SDL_min(BOT_TRAINER_FLOCK_SIZE, batch.evaluationsCount - index * BOT_TRAINER_FLOCK_SIZE);
+
+    // each task has its own flock, the workers share nothing but the read only settings.
+    BirdFlock flock;
+    initBirdFlock(flock, batch.dimensions, botsCount, settings.courseSeed);
+
+    BotGenome genomes[BOT_TRAINER_FLOCK_SIZE];
+
+    for (int i = 0; i < botsCount; i++)
+    {
+        genomes[i] = evaluations[i].genome;
+        evaluations[i].ticks = 0;
+    }
+
+    BotBatch bots;
+    initBotBatch(bots, genomes, botsCount);
+
+    const float deltaTime = 1.0f / settings.tickRate;
+    float inputs[BOT_INPUTS_COUNT];
+
+    while (flock.aliveCount > 0 && flock.tick < (Uint64)settings.maxTicks)
+    {
+        for (int slot = 0; slot < flock.aliveCount; slot++)
+        {
+            getBirdBotInputs(flock.pipes, flock.dimensions, flock.y[slot], flock.speed[slot], flock.impulse, inputs);
+            setBotBatchInputs(bots, slot, inputs);
+        }
+
+        runBotBatch(bots, flock.aliveCount);
+
+        if (stepBirdFlock(flock, bots.flaps.data(), deltaTime) == 0)
+        {
+            continue;
+        }
+
+        syncBotBatchSlots(bots, flock.birdIds.data(), flock.aliveCount);
+
+        // the gap offset is taken right after the death, while the pipes are where they were.
+        for (int i = 0; i < botsCount; i++)
+        {
+            if (!flock.isAlive[i] && evaluations[i].ticks == 0)
+            {
+                getBirdBotInputs(flock.pipes, flock.dimensions, flock.deathY[i], 0, flock.impulse, inputs);
+
+                evaluations[i].ticks = flock.deathTicks[i];
+                evaluations[i].score = flock.scores[i];
+                evaluations[i].fitness = getBotFitness(evaluations[i].ticks, evaluations[i].score, inputs[3], settings);
+            }
+        }
+    }
+
+    for (int slot = 0; slot < flock.aliveCount; slot++)
+    {
+        BotEvaluation &evaluation = evaluations[flock.birdIds[slot]];
+
+        getBirdBotInputs(flock.pipes, flock.dimensions, flock.y[slot], 0, flock.impulse, inputs);
+
+        evaluation.ticks = flock.tick;
+        evaluation.score = flock.score;
+        evaluation.fitness = getBotFitness(evaluation.ticks, evaluation.score, inputs[3], settings);
+    }
+}
+
+float nextRandomSigned(RandomGenerator &random)
+{
+    return nextRandomFloat(random) * 2 - 1;
+}
+
+// box-muller, one of the two values is thrown away.
+float nextRandomGaussian(RandomGenerator &random)
+{
+    float u = 1 - nextRandomFloat(random);
+    float v = nextRandomFloat(random);
+
+    return std::sqrt(-2 * std::log(u)) * std::cos(6.28318531f * v);
+}
+
+const BotEvaluation &selectParent(const std::vector<BotEvaluation> &evaluations, RandomGenerator &random)
+{
+    // tournament of 3.
+    const BotEvaluation *best = &evaluations[nextRandomBounded(random, evaluations.size())];
+
+    for (int i = 0; i < 2; i++)
+    {
+        const BotEvaluation &contender = evaluations[nextRandomBounded(random, evaluations.size())];
+
+        if (contender.fitness > best->fitness)
+        {
+            best = &contender;
+        }
+    }
+
+    return *best;
+}
+
+void mutateBotGenome(BotGenome &genome, float mutationRate, float mutationStrength, RandomGenerator &random)
+{
+    for (float &weight : genome.weights)
+    {
+        if (nextRandomFloat(random) < mutationRate)
+        {
+            weight += nextRandomGaussian(random) * mutationStrength;
+        }
+    }
+}
+
+void breedBot(const BotEvaluation &mother, const BotEvaluation &father, const BotTrainerSettings &settings, RandomGenerator &random,
+              BotGenome &child)
+{
+    for (int i = 0; i < BOT_WEIGHTS_COUNT; i++)
+    {
+        child.weights[i] = (nextRandom(random) & 1) ? mother.genome.weights[i] : father.genome.weights[i];
+    }
+
+    mutateBotGenome(child, settings.mutationRate, settings.mutationStrength, random);
+}
+
+BotGenome trainBots(const BotTrainerSettings &settings, const GameDimensions &dimensions)
+{
+    RandomGenerator random;
+    seedRandomGenerator(random, settings.trainingSeed);
+
+    int populationSize = std::max(2, settings.populationSize);
+    int elitesCount = SDL_clamp(settings.elitesCount, 1, populationSize);
+
+    std::vector<BotEvaluation> evaluations(populationSize);
+    std::vector<BotEvaluation> nextEvaluations(populationSize);
+
+    for (BotEvaluation &evaluation : evaluations)
+    {
+        for (float &weight : evaluation.genome.weights)
+        {
+            weight = nextRandomSigned(random);
+        }
+    }
+
+    ThreadPool pool;
+    startThreadPool(pool, settings.workersCount);
+
+    printf("training %d bots for %d generations on %d threads, course seed %llu, %s inference\n", populationSize,
+           settings.generationsCount, pool.workersCount, (unsigned long long)settings.courseSeed, getBotBatchKernelName(getBotBatchKernel()));
+
+    BotEvaluationBatch batch = {&settings, dimensions, nullptr, populationSize};
+    int flocksCount = (populationSize + BOT_TRAINER_FLOCK_SIZE - 1) / BOT_TRAINER_FLOCK_SIZE;
+    BotEvaluation best = {};
+    best.fitness = -INFINITY;
+
+    Uint64 totalTicks = 0;
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    for (int generation = 0; generation < settings.generationsCount; generation++)
+    {
+        batch.evaluations = evaluations.data();
+        runThreadPoolTasks(pool, flocksCount, evaluateBotFlockTask, &batch);
+
+        std::sort(evaluations.begin(), evaluations.end(),
+                  [](const BotEvaluation &a, const BotEvaluation &b) { return a.fitness > b.fitness; });
+
+        float fitnessSum = 0;
+
+        for (const BotEvaluation &evaluation : evaluations)
+        {
+            fitnessSum += evaluation.fitness;
+            totalTicks += evaluation.ticks;
+        }
+
+        if (evaluations[0].fitness > best.fitness)
+        {
+            best = evaluations[0];
+        }
+
+        printf("generation %d: best score %d fitness %.0f, mean fitness %.0f\n", generation + 1, evaluations[0].score,
+               evaluations[0].fitness, fitnessSum / populationSize);
+
+        for (int i = 0; i < populationSize; i++)
+        {
+            if (i < elitesCount)
+            {
+                nextEvaluations[i].genome = evaluations[i].genome;
+                continue;
+            }
+
+            const BotEvaluation &mother = selectParent(evaluations, random);
+            const BotEvaluation &father = selectParent(evaluations, random);
+
+            breedBot(mother, father, settings, random, nextEvaluations[i].genome);
+        }
+
+        evaluations.swap(nextEvaluations);
+    }
+
+    double elapsedSeconds = (double)(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
+
+    stopThreadPool(pool);
+
+    if (elapsedSeconds > 0)
+    {
+        printf("generations per second: %.2f\n", settings.generationsCount / elapsedSeconds);
+        printf("evaluations per second: %.0f\n", (double)settings.generationsCount * populationSize / elapsedSeconds);
+        printf("ticks per second: %.0f\n", totalTicks / elapsedSeconds);
+    }
+
+    printf("best score: %d\n", best.score);
+
+    return best.genome;
+}
+
+bool saveBotGenome(const char *filePath, const BotGenome &genome)
+{
+    std::string text = "bot " + std::to_string(BOT_WEIGHTS_COUNT) + "\n";
+    char weightText[32];
+
+    for (float weight : genome.weights)
+    {
+        SDL_snprintf(weightText, sizeof(weightText), "%.9g\n", weight);
+        text += weightText;
+    }
+
+    return writeFileAtomically(filePath, text.data(), text.size());
+}
+
+bool loadBotGenome(const char *filePath, BotGenome &genome)
+{
+    FILE *file = fopen(filePath, "rb");
+
+    if (file == nullptr)
+    {
+        printf("Failed to open the bot %s\n", filePath);
+        return false;
+    }
+
+    int weightsCount = 0;
+    bool isLoaded = fscanf(file, "bot %d", &weightsCount) == 1 && weightsCount == BOT_WEIGHTS_COUNT;
+
+    for (int i = 0; i < BOT_WEIGHTS_COUNT && isLoaded; i++)
+    {
+        isLoaded = fscanf(file, "%f", &genome.weights[i]) == 1;
+    }
+
+    fclose(file);
+
+    if (!isLoaded)
+    {
+        printf("The bot %s doesn't match this network\n", filePath);
+    }
+
+    return isLoaded;
+}
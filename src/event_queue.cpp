@@ -0,0 +1,41 @@
+#include "event_queue.h"
+
+void initEventQueue(EventQueue &queue)
+{
+    SDL_AtomicSet(&queue.writtenEvents, 0);
+    SDL_AtomicSet(&queue.readEvents, 0);
+}
+
+bool pushQueuedEvent(EventQueue &queue, int code, Uint64 inputCounter)
+{
+    int writtenEvents = SDL_AtomicGet(&queue.writtenEvents);
+
+    if (writtenEvents - SDL_AtomicGet(&queue.readEvents) >= EVENT_QUEUE_SIZE)
+    {
+        return false;
+    }
+
+    queue.events[(Uint32)writtenEvents % EVENT_QUEUE_SIZE] = {code, inputCounter};
+
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&queue.writtenEvents, writtenEvents + 1);
+
+    return true;
+}
+
+bool popQueuedEvent(EventQueue &queue, QueuedEvent &event)
+{
+    int readEvents = SDL_AtomicGet(&queue.readEvents);
+
+    if (readEvents == SDL_AtomicGet(&queue.writtenEvents))
+    {
+        return false;
+    }
+
+    SDL_MemoryBarrierAcquire();
+    event = queue.events[(Uint32)readEvents % EVENT_QUEUE_SIZE];
+
+    SDL_AtomicSet(&queue.readEvents, readEvents + 1);
+
+    return true;
+}
@@ -0,0 +1,91 @@
+#include "frame_profiler.h"
+#include <algorithm>
+#include <cstdio>
+
+void initFrameProfiler(FrameProfiler &profiler)
+{
+    profiler = FrameProfiler{};
+    profiler.frequency = SDL_GetPerformanceFrequency();
+    profiler.lastMark = SDL_GetPerformanceCounter();
+}
+
+void beginProfilerFrame(FrameProfiler &profiler)
+{
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        profiler.samples[phase][profiler.frameIndex] = 0;
+    }
+
+    profiler.lastMark = SDL_GetPerformanceCounter();
+}
+
+void markProfilerPhase(FrameProfiler &profiler, FramePhase phase)
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    profiler.samples[phase][profiler.frameIndex] += (float)((double)(now - profiler.lastMark) * 1000 / profiler.frequency);
+    profiler.lastMark = now;
+}
+
+void endProfilerFrame(FrameProfiler &profiler)
+{
+    profiler.frameIndex = (profiler.frameIndex + 1) % PROFILER_HISTORY_SIZE;
+
+    if (profiler.recordedFrames < PROFILER_HISTORY_SIZE)
+    {
+        profiler.recordedFrames++;
+    }
+}
+
+PhaseStats getPhaseStats(const FrameProfiler &profiler, FramePhase phase)
+{
+    PhaseStats stats = {0, 0, 0, 0};
+
+    if (profiler.recordedFrames == 0)
+    {
+        return stats;
+    }
+
+    int lastFrame = (profiler.frameIndex + PROFILER_HISTORY_SIZE - 1) % PROFILER_HISTORY_SIZE;
+    stats.current = profiler.samples[phase][lastFrame];
+
+    // while the buffer is filling up the recorded frames are the first ones.
+    float sorted[PROFILER_HISTORY_SIZE];
+    std::copy(profiler.samples[phase], profiler.samples[phase] + profiler.recordedFrames, sorted);
+    std::sort(sorted, sorted + profiler.recordedFrames);
+
+    stats.p50 = sorted[(profiler.recordedFrames - 1) * 50 / 100];
+    stats.p99 = sorted[(profiler.recordedFrames - 1) * 99 / 100];
+    stats.max = sorted[profiler.recordedFrames - 1];
+
+    return stats;
+}
+
+const char *getPhaseName(FramePhase phase)
+{
+    switch (phase)
+    {
+    case PHASE_EVENTS:
+        return "events";
+    case PHASE_UPDATE:
+        return "update";
+    case PHASE_RENDER:
+        return "render";
+    case PHASE_PRESENT:
+        return "present";
+    case PHASE_PACING:
+        return "pacing";
+    default:
+        return "unknown";
+    }
+}
+
+std::string formatPhaseStats(const FrameProfiler &profiler, FramePhase phase)
+{
+    PhaseStats stats = getPhaseStats(profiler, phase);
+
+    char line[96];
+    snprintf(line, sizeof(line), "%-8s %6.2f %6.2f %6.2f %6.2f", getPhaseName(phase), stats.current, stats.p50, stats.p99, stats.max);
+
+    return line;
+}
@@ -0,0 +1,123 @@
+#include "game_env.h"
+
+// every episode of every instance flies its own course, and the same env seed gives the same courses.
+Uint64 getEpisodeSeed(const GameEnv &env, int instance)
+{
+    return env.seed + ((Uint64)instance << 32) + env.episodes[instance];
+}
+
+void startEpisode(GameEnv &env, int instance)
+{
+    GameState &game = env.games[instance];
+
+    initGameState(game, game.dimensions, getEpisodeSeed(env, instance));
+    getBotInputs(game, &env.observations[instance * GAME_ENV_OBSERVATION_SIZE]);
+}
+
+void stepGameEnvTask(void *data, int index)
+{
+    GameEnv &env = *(GameEnv *)data;
+
+    int first = index * GAME_ENV_BATCH_SIZE;
+    int last = SDL_min(first + GAME_ENV_BATCH_SIZE, env.instancesCount);
+
+    const InputAction flapInput = INPUT_FLAP;
+
+    for (int instance = first; instance < last; instance++)
+    {
+        GameState &game = env.games[instance];
+
+        int previousScore = game.score;
+        stepGame(game, &flapInput, env.actions[instance] ? 1 : 0, env.deltaTime);
+
+        float reward = game.score - previousScore;
+        bool isTruncated = !game.isGameOver && env.maxEpisodeTicks > 0 && game.tick >= env.maxEpisodeTicks;
+        bool isDone = game.isGameOver || isTruncated;
+
+        if (game.isGameOver)
+        {
+            reward -= 1;
+        }
+
+        env.rewards[instance] = reward;
+        env.dones[instance] = isDone;
+        env.truncations[instance] = isTruncated;
+
+        if (isDone)
+        {
+            env.episodeScores[instance] = game.score;
+            env.episodeTicks[instance] = game.tick;
+            env.episodeSeeds[instance] = game.seed;
+            env.episodes[instance]++;
+
+            startEpisode(env, instance);
+        }
+        else
+        {
+            getBotInputs(game, &env.observations[instance * GAME_ENV_OBSERVATION_SIZE]);
+        }
+    }
+}
+
+void createGameEnv(GameEnv &env, int instancesCount, Uint64 seed, const GameDimensions &dimensions, int tickRate, int workersCount)
+{
+    env.instancesCount = instancesCount;
+    env.seed = seed;
+    env.deltaTime = 1.0f / tickRate;
+    env.maxEpisodeTicks = 0;
+
+    env.games.resize(instancesCount);
+    env.episodes.assign(instancesCount, 0);
+    env.observations.assign(instancesCount * GAME_ENV_OBSERVATION_SIZE, 0);
+    env.rewards.assign(instancesCount, 0);
+    env.dones.assign(instancesCount, 0);
+    env.truncations.assign(instancesCount, 0);
+    env.episodeScores.assign(instancesCount, 0);
+    env.episodeTicks.assign(instancesCount, 0);
+    env.episodeSeeds.assign(instancesCount, 0);
+    env.actions = nullptr;
+
+    for (GameState &game : env.games)
+    {
+        game.dimensions = dimensions;
+    }
+
+    startThreadPool(env.pool, workersCount);
+
+    for (int instance = 0; instance < instancesCount; instance++)
+    {
+        startEpisode(env, instance);
+    }
+}
+
+void resetGameEnv(GameEnv &env)
+{
+    // the interrupted episode counts like a finished one, so the new one flies the next course.
+    for (int instance = 0; instance < env.instancesCount; instance++)
+    {
+        env.rewards[instance] = 0;
+        env.dones[instance] = 0;
+        env.truncations[instance] = 0;
+        env.episodes[instance]++;
+
+        startEpisode(env, instance);
+    }
+}
+
+void stepGameEnv(GameEnv &env, const Uint8 *actions)
+{
+    env.actions = actions;
+
+    int batchesCount = (env.instancesCount + GAME_ENV_BATCH_SIZE - 1) / GAME_ENV_BATCH_SIZE;
+    runThreadPoolTasks(env.pool, batchesCount, stepGameEnvTask, &env);
+
+    env.actions = nullptr;
+}
+
+void destroyGameEnv(GameEnv &env)
+{
+    stopThreadPool(env.pool);
+
+    // frees every array and leaves no instances, a destroyed env can't be stepped by mistake.
+    env = GameEnv{};
+}
@@ -0,0 +1,286 @@
+#include "game_state.h"
+
+void saveGamePreviousState(GameState &game)
+{
+    game.previousPlayerY = game.playerY;
+    game.previousAngle = game.angle;
+
+    for (int i = 0; i < GROUND_TILES_COUNT; i++)
+    {
+        game.previousGroundPositions[i] = game.groundPositions[i];
+    }
+
+    savePipePairsPositions(game.pipes);
+}
+
+void initGameState(GameState &game, const GameDimensions &dimensions, Uint64 seed)
+{
+    game.dimensions = dimensions;
+
+    float groundYPosition = SCREEN_HEIGHT - dimensions.groundHeight;
+
+    game.groundCollisionBounds = {0, (int)groundYPosition, SCREEN_WIDTH, dimensions.groundHeight};
+
+    for (int i = 0; i < GROUND_TILES_COUNT; i++)
+    {
+        game.groundPositions[i] = {(float)dimensions.groundWidth * i, groundYPosition};
+    }
+
+    game.playerY = SCREEN_HEIGHT / 2;
+    game.birdBounds = {SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, dimensions.birdWidth, dimensions.birdHeight};
+    game.gravity = 0;
+    game.impulse = -10000;
+    game.gravityIncrement = 400;
+
+    game.angle = 0;
+    game.shouldRotateUp = false;
+    game.upRotationTimer = 0;
+    game.downRotationTimer = 0;
+    game.startGameTimer = 0;
+
+    game.isGameOver = false;
+    game.isGamePaused = false;
+    game.isSimpleGraphicsMode = false;
+
+    game.score = 0;
+    game.highScore = 0;
+
+    clearPipePairs(game.pipes);
+    game.distanceSinceLastPipe = 0;
+
+    // the top of the gap is up to 219 pixels above the bottom of the up pipe sprite placed at y 0.
+    initPipeCourse(game.pipeCourse, seed, dimensions.pipeHeight + PIPE_GAP_HEIGHT / 2, 220, PIPE_GAP_HEIGHT);
+
+    game.seed = seed;
+    game.tick = 0;
+    game.runStartTick = 0;
+
+    saveGamePreviousState(game);
+}
+
+GameStepResult resetGame(GameState &game)
+{
+    GameStepResult result = {};
+
+    if (game.isGameOver)
+    {
+        result.isRunFinished = true;
+        result.finishedRunScore = game.score;
+        result.finishedRunTicks = game.tick - game.runStartTick;
+        result.finishedRunSeed = game.seed;
+    }
+
+    game.runStartTick = game.tick;
+
+    if (game.score > game.highScore)
+    {
+        game.highScore = game.score;
+        result.isNewHighScore = true;
+    }
+
+    game.isGameOver = false;
+    game.startGameTimer = 0;
+    game.score = 0;
+    game.angle = 0;
+
+    game.playerY = SCREEN_HEIGHT / 2;
+    game.birdBounds.x = SCREEN_WIDTH / 2;
+    game.birdBounds.y = SCREEN_HEIGHT / 2;
+
+    game.gravity = 0;
+    clearPipePairs(game.pipes);
+
+    saveGamePreviousState(game);
+
+    return result;
+}
+
+void flap(GameState &game)
+{
+    // the impulse was tuned against a 60 fps frame time, use that instead of the tick time so
+    // the jump height is the same at every tick rate.
+    game.gravity = game.impulse / FRAME_RATE;
+
+    game.shouldRotateUp = true;
+    game.upRotationTimer = 1;
+    game.downRotationTimer = 0;
+    game.angle = -20;
+}
+
+GameStepResult applyGameInput(GameState &game, InputAction action)
+{
+    GameStepResult result = {};
+
+    switch (action)
+    {
+    case INPUT_FLAP:
+        flap(game);
+        result.sounds |= GAME_SOUND_FLAP;
+        break;
+    case INPUT_PAUSE:
+        game.isGamePaused = !game.isGamePaused;
+        result.sounds |= GAME_SOUND_PAUSE;
+        break;
+    case INPUT_RESET:
+        result = resetGame(game);
+        break;
+    }
+
+    return result;
+}
+
+void updateBirdRotation(GameState &game, float deltaTime)
+{
+    game.downRotationTimer += deltaTime;
+
+    if (game.shouldRotateUp)
+    {
+        if (game.upRotationTimer > 0)
+        {
+            game.upRotationTimer -= deltaTime;
+        }
+
+        if (game.upRotationTimer <= 0)
+        {
+            game.shouldRotateUp = false;
+        }
+    }
+
+    // 2 degrees per frame at 60 fps.
+    if (game.downRotationTimer > 0.5f && game.angle <= 90)
+    {
+        game.angle += 120 * deltaTime;
+    }
+}
+
+void generatePipes(GameState &game)
+{
+    PipeLayout layout = nextPipeLayout(game.pipeCourse);
+
+    // the distance scrolled past the spacing in this tick, so the pipes stay exactly PIPE_SPACING apart.
+    game.distanceSinceLastPipe -= PIPE_SPACING;
+
+    pushPipePair(game.pipes, SCREEN_WIDTH - game.distanceSinceLastPipe, layout.gapCenter, layout.gapHeight);
+}
+
+Uint32 updateGame(GameState &game, float deltaTime)
+{
+    Uint32 sounds = 0;
+
+    game.tick++;
+
+    game.startGameTimer += deltaTime;
+
+    game.distanceSinceLastPipe += SCROLL_SPEED * deltaTime;
+
+    if (game.distanceSinceLastPipe >= PIPE_SPACING)
+    {
+        generatePipes(game);
+    }
+
+    if (game.playerY < -game.birdBounds.h || (game.isSimpleGraphicsMode && game.playerY < -SIMPLE_BIRD_HEIGHT))
+    {
+        game.isGameOver = true;
+    }
+
+    if (game.startGameTimer > 1)
+    {
+        // exact integration under constant acceleration, so the trajectory doesn't depend on the tick rate.
+        game.playerY += game.gravity * deltaTime + 0.5f * game.gravityIncrement * deltaTime * deltaTime;
+        game.birdBounds.y = game.playerY;
+
+        game.gravity += game.gravityIncrement * deltaTime;
+
+        updateBirdRotation(game, deltaTime);
+    }
+
+    if (SDL_HasIntersection(&game.birdBounds, &game.groundCollisionBounds))
+    {
+        game.isGameOver = true;
+        sounds |= GAME_SOUND_DIE;
+    }
+
+    for (Vector2 &groundPosition : game.groundPositions)
+    {
+        groundPosition.x -= SCROLL_SPEED * deltaTime;
+
+        if (groundPosition.x < -game.dimensions.groundWidth)
+        {
+            groundPosition.x = game.dimensions.groundWidth * (GROUND_TILES_COUNT - 1);
+        }
+    }
+
+    SDL_FRect birdBounds = {(float)game.birdBounds.x, game.playerY, (float)game.birdBounds.w, (float)game.birdBounds.h};
+
+    PipePairsStep pipesStep = movePipePairs(game.pipes, SCROLL_SPEED * deltaTime, birdBounds, game.dimensions.pipeWidth);
+
+    if (pipesStep.isBirdColliding)
+    {
+        game.isGameOver = true;
+        sounds |= GAME_SOUND_DIE;
+    }
+
+    if (pipesStep.passedPairs > 0)
+    {
+        game.score += pipesStep.passedPairs;
+        sounds |= GAME_SOUND_POINT;
+    }
+
+    removePassedPipePairs(game.pipes, game.dimensions.pipeWidth);
+
+    return sounds;
+}
+
+GameStepResult stepGame(GameState &game, const InputAction *inputs, int inputsCount, float deltaTime)
+{
+    GameStepResult result = {};
+
+    for (int i = 0; i < inputsCount; i++)
+    {
+        GameStepResult inputResult = applyGameInput(game, inputs[i]);
+
+        Uint32 sounds = result.sounds | inputResult.sounds;
+        bool isNewHighScore = result.isNewHighScore || inputResult.isNewHighScore;
+
+        if (inputResult.isRunFinished)
+        {
+            result = inputResult;
+        }
+
+        result.sounds = sounds;
+        result.isNewHighScore = isNewHighScore;
+    }
+
+    if (!isGameWaiting(game))
+    {
+        saveGamePreviousState(game);
+        result.sounds |= updateGame(game, deltaTime);
+    }
+
+    return result;
+}
+
+bool isGameWaiting(const GameState &game)
+{
+    return game.isGameOver || game.isGamePaused;
+}
+
+bool shouldAutopilotFlap(const GameState &game)
+{
+    float gapCenter = SCREEN_HEIGHT / 2;
+
+    for (int i = 0; i < game.pipes.count; i++)
+    {
+        int index = getPipePairIndex(game.pipes, i);
+
+        if (game.pipes.x[index] + game.dimensions.pipeWidth > game.birdBounds.x)
+        {
+            gapCenter = game.pipes.gapCenter[index];
+            break;
+        }
+    }
+
+    float birdCenter = game.playerY + game.birdBounds.h / 2;
+
+    return game.gravity > 0 && birdCenter > gapCenter + 10;
+}
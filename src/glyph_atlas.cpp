@@ -0,0 +1,118 @@
+#include "glyph_atlas.h"
+#include "texture_cache.h"
+
+// wide enough for every printable ascii glyph of the fonts the game uses in a few rows.
+const int GLYPH_ATLAS_WIDTH = 1024;
+
+bool buildGlyphAtlas(SDL_Renderer *renderer, TTF_Font *font, GlyphAtlas &atlas)
+{
+    atlas = GlyphAtlas{};
+
+    if (font == nullptr)
+    {
+        return false;
+    }
+
+    SDL_Color fontColor = {255, 255, 255, 255};
+    SDL_Surface *glyphSurfaces[GLYPH_ATLAS_CHARACTERS_COUNT] = {};
+
+    int x = 0;
+    int y = 0;
+    int rowHeight = 0;
+
+    for (int i = 0; i < GLYPH_ATLAS_CHARACTERS_COUNT; i++)
+    {
+        SDL_Surface *surface = TTF_RenderGlyph32_Blended(font, GLYPH_ATLAS_FIRST_CHARACTER + i, fontColor);
+
+        if (surface == nullptr)
+        {
+            continue;
+        }
+
+        glyphSurfaces[i] = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(surface);
+
+        if (glyphSurfaces[i] == nullptr)
+        {
+            continue;
+        }
+
+        if (x + glyphSurfaces[i]->w > GLYPH_ATLAS_WIDTH)
+        {
+            x = 0;
+            y += rowHeight + 1;
+            rowHeight = 0;
+        }
+
+        atlas.glyphs[i] = {x, y, glyphSurfaces[i]->w, glyphSurfaces[i]->h};
+
+        x += glyphSurfaces[i]->w + 1;
+        rowHeight = SDL_max(rowHeight, glyphSurfaces[i]->h);
+    }
+
+    atlas.lineHeight = TTF_FontHeight(font);
+
+    SDL_Surface *atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, GLYPH_ATLAS_WIDTH, y + rowHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+
+    if (atlasSurface != nullptr)
+    {
+        SDL_FillRect(atlasSurface, NULL, SDL_MapRGBA(atlasSurface->format, 0, 0, 0, 0));
+
+        for (int i = 0; i < GLYPH_ATLAS_CHARACTERS_COUNT; i++)
+        {
+            if (glyphSurfaces[i] != nullptr)
+            {
+                SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(glyphSurfaces[i], NULL, atlasSurface, &atlas.glyphs[i]);
+            }
+        }
+
+        atlas.texture = createTextureFromPixels(renderer, atlasSurface);
+
+        SDL_FreeSurface(atlasSurface);
+    }
+
+    for (SDL_Surface *glyphSurface : glyphSurfaces)
+    {
+        SDL_FreeSurface(glyphSurface);
+    }
+
+    return atlas.texture != nullptr;
+}
+
+void destroyGlyphAtlas(GlyphAtlas &atlas)
+{
+    SDL_DestroyTexture(atlas.texture);
+    atlas.texture = nullptr;
+}
+
+const SDL_Rect &getGlyph(const GlyphAtlas &atlas, char character)
+{
+    int index = (unsigned char)character - GLYPH_ATLAS_FIRST_CHARACTER;
+
+    if (index < 0 || index >= GLYPH_ATLAS_CHARACTERS_COUNT)
+    {
+        index = 0;
+    }
+
+    return atlas.glyphs[index];
+}
+
+int drawText(SpriteBatch &batch, const GlyphAtlas &atlas, const char *text, int x, int y)
+{
+    int startX = x;
+
+    for (const char *character = text; *character != '\0'; character++)
+    {
+        const SDL_Rect &glyph = getGlyph(atlas, *character);
+
+        if (atlas.texture != nullptr && glyph.w > 0)
+        {
+            drawTexturedQuad(batch, atlas.texture, glyph, {(float)x, (float)y, (float)glyph.w, (float)glyph.h}, 0);
+        }
+
+        x += glyph.w;
+    }
+
+    return x - startX;
+}
@@ -0,0 +1,208 @@
+#include "high_score_writer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+int loadHighScore(const char *filePath)
+{
+    FILE *file = fopen(filePath, "rb");
+
+    if (file == nullptr)
+    {
+        return 0;
+    }
+
+    char text[32] = {};
+    size_t length = fread(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+
+    text[length] = '\0';
+
+    char *end = nullptr;
+    long highScore = strtol(text, &end, 10);
+
+    if (end == text || highScore < 0 || highScore > SDL_MAX_SINT32)
+    {
+        printf("Ignoring the unreadable high score in %s\n", filePath);
+        return 0;
+    }
+
+    return (int)highScore;
+}
+
+bool flushFileToDisk(FILE *file)
+{
+    if (fflush(file) != 0)
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool replaceFile(const char *temporaryFilePath, const char *filePath)
+{
+#ifdef _WIN32
+    return MoveFileExA(temporaryFilePath, filePath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (rename(temporaryFilePath, filePath) != 0)
+    {
+        return false;
+    }
+
+    // the rename itself only survives a crash once the directory entry is on the disk.
+    std::string directoryPath = filePath;
+    size_t separator = directoryPath.find_last_of('/');
+    directoryPath = separator == std::string::npos ? "." : directoryPath.substr(0, separator + 1);
+
+    int directory = open(directoryPath.c_str(), O_RDONLY);
+
+    if (directory >= 0)
+    {
+        fsync(directory);
+        close(directory);
+    }
+
+    return true;
+#endif
+}
+
+bool writeFileAtomically(const char *filePath, const void *data, size_t size)
+{
+    std::string temporaryFilePath = std::string(filePath) + ".tmp";
+
+    FILE *file = fopen(temporaryFilePath.c_str(), "wb");
+
+    if (file == nullptr)
+    {
+        printf("Failed to write %s\n", temporaryFilePath.c_str());
+        return false;
+    }
+
+    bool isWritten = fwrite(data, 1, size, file) == size && flushFileToDisk(file);
+
+    isWritten = fclose(file) == 0 && isWritten;
+
+    if (isWritten)
+    {
+        isWritten = replaceFile(temporaryFilePath.c_str(), filePath);
+    }
+
+    if (!isWritten)
+    {
+        printf("Failed to write %s\n", filePath);
+        remove(temporaryFilePath.c_str());
+    }
+
+    return isWritten;
+}
+
+void writeHighScore(const char *filePath, int score)
+{
+    std::string scoreText = std::to_string(score);
+
+    writeFileAtomically(filePath, scoreText.data(), scoreText.size());
+}
+
+int runHighScoreWriter(void *data)
+{
+    HighScoreWriter &writer = *(HighScoreWriter *)data;
+
+    SDL_LockMutex(writer.mutex);
+
+    while (true)
+    {
+        while (!writer.hasPendingScore && !writer.isStopping)
+        {
+            SDL_CondWait(writer.condition, writer.mutex);
+        }
+
+        if (writer.hasPendingScore)
+        {
+            int score = writer.pendingScore;
+            writer.hasPendingScore = false;
+
+            // the game thread can keep requesting saves while this one is on the disk.
+            SDL_UnlockMutex(writer.mutex);
+            writeHighScore(writer.filePath, score);
+            SDL_LockMutex(writer.mutex);
+
+            continue;
+        }
+
+        if (writer.isStopping)
+        {
+            break;
+        }
+    }
+
+    SDL_UnlockMutex(writer.mutex);
+
+    return 0;
+}
+
+void startHighScoreWriter(HighScoreWriter &writer, const char *filePath)
+{
+    writer = HighScoreWriter{};
+    writer.filePath = filePath;
+    writer.mutex = SDL_CreateMutex();
+    writer.condition = SDL_CreateCond();
+
+    if (writer.mutex != nullptr && writer.condition != nullptr)
+    {
+        writer.thread = SDL_CreateThread(runHighScoreWriter, "high score writer", &writer);
+    }
+
+    if (writer.thread == nullptr)
+    {
+        printf("Failed to start the high score writer, saving on the game thread: %s\n", SDL_GetError());
+    }
+}
+
+void requestHighScoreSave(HighScoreWriter &writer, int score)
+{
+    if (writer.thread == nullptr)
+    {
+        writeHighScore(writer.filePath, score);
+        return;
+    }
+
+    SDL_LockMutex(writer.mutex);
+    writer.pendingScore = score;
+    writer.hasPendingScore = true;
+    SDL_CondSignal(writer.condition);
+    SDL_UnlockMutex(writer.mutex);
+}
+
+void stopHighScoreWriter(HighScoreWriter &writer)
+{
+    if (writer.thread != nullptr)
+    {
+        SDL_LockMutex(writer.mutex);
+        writer.isStopping = true;
+        SDL_CondSignal(writer.condition);
+        SDL_UnlockMutex(writer.mutex);
+
+        SDL_WaitThread(writer.thread, nullptr);
+        writer.thread = nullptr;
+    }
+
+    SDL_DestroyCond(writer.condition);
+    SDL_DestroyMutex(writer.mutex);
+    writer.condition = nullptr;
+    writer.mutex = nullptr;
+}
@@ -0,0 +1,99 @@
+#include "input_recorder.h"
+#include <fstream>
+#include <string>
+
+// text format, one input per line:
+// flappy-replay 1
+// seed <seed>
+// tick-rate <ticks per second>
+// inputs <count>
+// <tick> <action>
+// end <final tick> <final score>
+const char *REPLAY_HEADER = "flappy-replay";
+const int REPLAY_VERSION = 1;
+
+void recordInput(InputRecording &recording, Uint64 tick, InputAction action)
+{
+    recording.inputs.push_back({tick, action});
+}
+
+bool saveInputRecording(const InputRecording &recording, const char *filePath)
+{
+    std::ofstream replayFile(filePath);
+
+    if (!replayFile.is_open())
+    {
+        printf("Failed to write the replay %s\n", filePath);
+        return false;
+    }
+
+    replayFile << REPLAY_HEADER << " " << REPLAY_VERSION << "\n";
+    replayFile << "seed " << recording.seed << "\n";
+    replayFile << "tick-rate " << recording.tickRate << "\n";
+    replayFile << "inputs " << recording.inputs.size() << "\n";
+
+    for (const RecordedInput &input : recording.inputs)
+    {
+        replayFile << input.tick << " " << (int)input.action << "\n";
+    }
+
+    replayFile << "end " << recording.finalTick << " " << recording.finalScore << "\n";
+
+    return replayFile.good();
+}
+
+bool loadInputRecording(InputRecording &recording, const char *filePath)
+{
+    std::ifstream replayFile(filePath);
+
+    std::string header;
+    int version = 0;
+    std::string label;
+    size_t inputsCount = 0;
+
+    replayFile >> header >> version;
+
+    if (!replayFile || header != REPLAY_HEADER || version != REPLAY_VERSION)
+    {
+        printf("%s is not a replay file\n", filePath);
+        return false;
+    }
+
+    replayFile >> label >> recording.seed;
+    replayFile >> label >> recording.tickRate;
+    replayFile >> label >> inputsCount;
+
+    // the count comes from the file, so nothing is reserved up front, a corrupt one just runs out of lines.
+    recording.inputs.clear();
+
+    for (size_t i = 0; i < inputsCount && replayFile; i++)
+    {
+        RecordedInput input;
+        int action = -1;
+
+        if (!(replayFile >> input.tick >> action))
+        {
+            break;
+        }
+
+        if (action < INPUT_FLAP || action > INPUT_RESET)
+        {
+            printf("The replay %s has an unknown input %d\n", filePath, action);
+            return false;
+        }
+
+        input.action = (InputAction)action;
+
+        recording.inputs.push_back(input);
+    }
+
+    replayFile >> label >> recording.finalTick >> recording.finalScore;
+
+    if (!replayFile || label != "end" || recording.tickRate <= 0)
+    {
+        printf("The replay %s is truncated\n", filePath);
+        return false;
+    }
+
+    return true;
+}
@@ -1,28 +1,97 @@
 #include "sdl_starter.h"
 #include "sdl_assets_loader.h"
+#include "frame_profiler.h"
+#include "texture_atlas.h"
+#include "sprite_batch.h"
+#include "game_state.h"
+#include "async_assets_loader.h"
+#include "asset_pack.h"
+#include "texture_cache.h"
+#include "glyph_atlas.h"
+#include "render_layer.h"
+#include "high_score_writer.h"
+#include "run_history.h"
+#include "audio_engine.h"
+#include "triple_buffer.h"
+#include "event_queue.h"
+#include "bot_trainer.h"
+#include "bird_flock.h"
+#include "bird_collisions.h"
+#include "bot_batch.h"
+#include "game_env.h"
 #include <vector>
-#include <fstream>
-
-bool isSimpleGraphicsMode;
-bool isGameOver;
-bool isGamePaused;
-float startGameTimer;
-
-bool shouldRotateUp = false;
-float downRotationTimer = 0;
-float upRotationTimer = 0;
-
-float gravity = 0;
-float testY;
+#include <algorithm>
+#include <ctime>
+#include <climits>
+
+bool isHeadless;
+
+// the one game this process shows or runs headless, every bit of simulation state lives in it.
+GameState game;
+
+// a trained bot flies the bird instead of the scripted autopilot.
+bool isBotPlaying;
+BotGenome botGenome;
+
+// with --flock a population of birds flies one course instead of the single bird of the game.
+// each one has its own controller: a mutated copy of the bot, or the autopilot with its own flap margin.
+bool isFlockMode;
+int flockBirdsCount;
+BirdFlock flock;
+std::vector<BotGenome> flockGenomes;
+// the networks of the flock's bots, evaluated together each tick.
+BotBatch flockBots;
+std::vector<float> flockFlapMargins;
+std::vector<Uint8> flockFlaps;
+
+// with --env many independent games are stepped together like a training framework would, one of them is shown.
+bool isEnvMode;
+int envInstancesCount;
+int envWorkersCount;
+GameEnv env;
+std::vector<Uint8> envActions;
+int watchedEnvInstance;
+
+// above this many living birds they're drawn as a density band instead of one sprite each.
+const int FLOCK_DETAILED_BIRDS_LIMIT = 2048;
+// height in pixels of a band row.
+const int FLOCK_BAND_ROW_HEIGHT = 4;
+
+// the simulation always advances in ticks of 1 / tickRate seconds, independent of the frame rate.
+int tickRate = FRAME_RATE;
+
+// 0 follows the refresh rate of the display.
+int frameRate = 0;
+FramePacer framePacer;
+
+bool isProfilerOverlayVisible;
+FrameProfiler frameProfiler;
+TTF_Font *profilerFont = nullptr;
+// a header, one line per phase and the draw calls.
+const int PROFILER_OVERLAY_LINES = PHASE_COUNT + 2;
+std::string profilerLines[PROFILER_OVERLAY_LINES];
+GlyphAtlas profilerGlyphs;
+float profilerRefreshTimer;
 
 SDL_Window *window = nullptr;
 SDL_Renderer *renderer = nullptr;
 
-Mix_Chunk *gamePausedSound = nullptr;
-Mix_Chunk *flapSound = nullptr;
-Mix_Chunk *pauseSound = nullptr;
-Mix_Chunk *dieSound = nullptr;
-Mix_Chunk *crossPipeSound = nullptr;
+// a sound plays through SDL_mixer, or through the audio engine when it's enabled.
+typedef struct
+{
+    Mix_Chunk *chunk;
+    int engineSound;
+} Sound;
+
+Sound gamePausedSound = {nullptr, -1};
+Sound flapSound = {nullptr, -1};
+Sound pauseSound = {nullptr, -1};
+Sound dieSound = {nullptr, -1};
+Sound crossPipeSound = {nullptr, -1};
+
+// 0 keeps SDL_mixer, which has a 2048 frames buffer.
+int audioEngineBufferFrames = 0;
+AudioEngine audioEngine;
 
 SDL_Rect birdsBounds;
 Sprite birdSprites;
@@ -34,569 +103,1917 @@ Sprite groundSprite;
 Sprite upPipeSprite;
 Sprite downPipeSprite;
 
-std::vector<Sprite> numbers;
-std::vector<Sprite> numberTens;
-std::vector<Sprite> highScoreNumbers;
-std::vector<Sprite> highScoreNumberTens;
-
-typedef struct
-{
-    float y;
-    Sprite sprite;
-    float impulse;
-    float gravityIncrement;
-} Player;
-
-Player player;
-
-SDL_Rect simplePlayer = {SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, 34, 24};
+TextureAtlas textureAtlas;
 
-float groundYPosition;
-
-SDL_Rect groundCollisionBounds;
-
-SDL_Texture *highScoreTexture = nullptr;
-SDL_Rect highScoreBounds;
+// owns the decoded sound samples the mixer chunks point to.
+AsyncAssetsLoader assetsLoader;
+SpriteBatch spriteBatch;
 
 TTF_Font *fontSquare = nullptr;
+GlyphAtlas hudGlyphs;
 
-int score = 0;
-float initialAngle = 0;
-int highScore;
+// the background with the static ground, and the high score label with its digits.
+// they are only composed again when they change, every frame just draws them as one quad each.
+RenderLayer backgroundLayer;
+RenderLayer hudLayer;
 
-typedef struct
-{
-    float x;
-    float y;
-} Vector2;
+// read once at startup, afterwards the game's high score is the source of truth.
+const char *highScoreFilePath = "high-score.txt";
+HighScoreWriter highScoreWriter;
 
-std::vector<Vector2> groundPositions;
+// every finished run, for the leaderboard. headless runs only keep it when asked to.
+const char *runHistoryFilePath = "run-history.log";
+RunHistory runHistory;
 
+// everything render() reads from the simulation, copied after a tick so the simulation can run on its own thread.
+// the pipes are stored oldest first.
 typedef struct
 {
-    float x;
-    Sprite sprite;
-    bool isBehind;
-    bool isDestroyed;
-} Pipe;
+    float playerY;
+    float previousPlayerY;
+    float angle;
+    float previousAngle;
+
+    int pipesCount;
+    float pipesX[PIPE_PAIRS_CAPACITY];
+    float pipesPreviousX[PIPE_PAIRS_CAPACITY];
+    float pipesGapCenter[PIPE_PAIRS_CAPACITY];
+    float pipesGapHeight[PIPE_PAIRS_CAPACITY];
+
+    Vector2 groundPositions[GROUND_TILES_COUNT];
+    Vector2 previousGroundPositions[GROUND_TILES_COUNT];
+
+    int score;
+    int highScore;
+    bool isGameOver;
+    bool isGamePaused;
+    bool isSimpleGraphicsMode;
+
+    // the living birds of the flock, empty outside of the flock mode.
+    int flockAliveCount;
+    std::vector<float> flockY;
+    std::vector<float> flockPreviousY;
+    std::vector<float> flockAngle;
+    std::vector<float> flockPreviousAngle;
+
+    // performance counter when the tick ended, the render thread interpolates from there.
+    Uint64 tickCounter;
+} RenderSnapshot;
+
+// with --simulation-thread the ticks run on their own thread, so a slow present never holds them back.
+// the window events are still polled on the main thread and sent over as game events.
+bool isSimulationThreaded;
+SDL_Thread *simulationThread = nullptr;
+SDL_atomic_t isSimulationStopping;
+FramePacer simulationPacer;
+EventQueue gameEvents;
+TripleBuffer snapshotsBuffer;
+RenderSnapshot snapshots[3];
+
+enum GameEvent
+{
+    // the space bar or a mouse button, a flap while playing and a restart after a game over.
+    GAME_EVENT_PRESS,
+    GAME_EVENT_PAUSE,
+    GAME_EVENT_TOGGLE_SIMPLE_GRAPHICS
+};
+
+// 0 picks a different seed every launch.
+Uint64 gameSeed = 0;
 
-std::vector<Pipe> pipes;
+const char *recordingFilePath = nullptr;
+InputRecording inputRecording;
 
-float lastPipeSpawnTime;
+// when the press or key being handled happened, the sounds it causes are measured from it. 0 outside of an input.
+Uint64 handledInputCounter = 0;
 
-void generatePipes()
+void playSound(const Sound &sound)
 {
-    int upPipePosition = rand() % 220;
+    // in headless mode the mixer is never opened and the sounds stay null.
+    if (sound.chunk != nullptr)
+    {
+        Mix_PlayChannel(-1, sound.chunk, 0);
+    }
 
-    upPipePosition *= -1;
+    playEngineSound(audioEngine, sound.engineSound, handledInputCounter);
+}
 
-    SDL_Rect upPipeBounds = {SCREEN_WIDTH, upPipePosition, upPipeSprite.textureBounds.w, upPipeSprite.textureBounds.h};
+float interpolate(float previous, float current, float alpha)
+{
+    return previous + (current - previous) * alpha;
+}
 
-    Sprite upSprite = {upPipeSprite.texture, upPipeBounds};
+void addFinishedRun(const GameStepResult &result)
+{
+    Uint64 durationMilliseconds = result.finishedRunTicks * 1000 / tickRate;
 
-    Pipe upPipe = {SCREEN_WIDTH, upSprite, false, false};
+    addRun(runHistory, {(Sint64)time(nullptr), result.finishedRunSeed, result.finishedRunScore, (Uint32)std::min<Uint64>(durationMilliseconds, SDL_MAX_UINT32)});
+}
 
-    // gap size = 80.
-    int downPipePosition = upPipePosition + upPipeSprite.textureBounds.h + 80;
+// the game only reports what happened, the sounds, the run history and the saved high score are up to the host.
+void handleGameStepResult(const GameStepResult &result)
+{
+    if (result.sounds & GAME_SOUND_FLAP)
+    {
+        playSound(flapSound);
+    }
 
-    SDL_Rect downPipeBounds = {SCREEN_WIDTH, downPipePosition, downPipeSprite.textureBounds.w, downPipeSprite.textureBounds.h};
+    if (result.sounds & GAME_SOUND_PAUSE)
+    {
+        playSound(gamePausedSound);
+    }
 
-    Sprite downSprite = {downPipeSprite.texture, downPipeBounds};
+    if (result.sounds & GAME_SOUND_DIE)
+    {
+        playSound(dieSound);
+    }
 
-    Pipe downPipe = {SCREEN_WIDTH, downSprite, false, false};
+    if (result.sounds & GAME_SOUND_POINT)
+    {
+        playSound(crossPipeSound);
+    }
 
-    pipes.push_back(upPipe);
-    pipes.push_back(downPipe);
+    if (result.isRunFinished)
+    {
+        addFinishedRun(result);
+    }
 
-    lastPipeSpawnTime = 0;
+    // soak runs reset thousands of times, keep the high score in memory only.
+    if (result.isNewHighScore && !isHeadless)
+    {
+        requestHighScoreSave(highScoreWriter, game.highScore);
+    }
 }
 
-void saveScore()
+void saveRecording()
 {
-    std::ofstream highScores("high-score.txt");
+    if (recordingFilePath == nullptr)
+    {
+        return;
+    }
 
-    std::string scoreString = std::to_string(score);
-    // Write to the file
-    highScores << scoreString;
+    inputRecording.seed = game.seed;
+    inputRecording.tickRate = tickRate;
+    inputRecording.finalTick = game.tick;
+    inputRecording.finalScore = game.score;
 
-    // Close the file
-    highScores.close();
+    saveInputRecording(inputRecording, recordingFilePath);
 }
 
-int loadHighScore()
-{
-    std::string highScoreText;
+void stopSimulationThread();
 
-    // Read from the text file
-    std::ifstream highScores("high-score.txt");
+void quitGame()
+{
+    stopSimulationThread();
+    saveRecording();
+    closeRunHistory(runHistory);
 
-    // error! maybe the file doesn't exist
-    if (!highScores.is_open())
+    if (isHeadless)
     {
-        // if the file doesn't exist then lets create the file.
-        saveScore();
+        IMG_Quit();
+        SDL_Quit();
+        return;
+    }
 
-        std::ifstream auxHighScores("high-score.txt");
+    printFramePacerStats(framePacer);
 
-        getline(auxHighScores, highScoreText);
+    stopHighScoreWriter(highScoreWriter);
 
-        // Close the file
-        highScores.close();
+    Mix_FreeChunk(flapSound.chunk);
+    // with the atlas every sprite shares the same texture.
+    if (textureAtlas.texture != nullptr)
+    {
+        SDL_DestroyTexture(textureAtlas.texture);
+    }
+    else
+    {
+        SDL_DestroyTexture(playerSprite.texture);
+    }
 
-        int highScore = stoi(highScoreText);
+    destroyGlyphAtlas(hudGlyphs);
+    destroyRenderLayer(backgroundLayer);
+    destroyRenderLayer(hudLayer);
+    destroyGlyphAtlas(profilerGlyphs);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    Mix_CloseAudio();
 
-        return highScore;
+    if (audioEngine.device != 0)
+    {
+        closeAudioEngine(audioEngine);
+        printAudioEngineStats(audioEngine);
     }
 
-    // read the firstLine of the file and store the string data in my variable highScoreText.
-    getline(highScores, highScoreText);
-
-    // Close the file
-    highScores.close();
+    freeAsyncAssetsLoader(assetsLoader);
+    IMG_Quit();
+    TTF_Quit();
+    unmountAssetPack();
+    SDL_Quit();
+}
 
-    int highScore = stoi(highScoreText);
+// steps the game with inputs that are recorded at the tick they're applied.
+void stepRecordedGame(const InputAction *inputs, int inputsCount, float deltaTime)
+{
+    for (int i = 0; i < inputsCount && recordingFilePath != nullptr; i++)
+    {
+        recordInput(inputRecording, game.tick, inputs[i]);
+    }
 
-    return highScore;
+    handleGameStepResult(stepGame(game, inputs, inputsCount, deltaTime));
 }
 
-void resetGame(Player &player)
+// every input that changes the simulation goes through here so it can be recorded and replayed.
+void applyInput(InputAction action)
 {
-    if (score > highScore)
+    if (recordingFilePath != nullptr)
     {
-        saveScore();
+        recordInput(inputRecording, game.tick, action);
     }
 
-    highScore = loadHighScore();
+    handleGameStepResult(applyGameInput(game, action));
+}
+
+void handleAutopilot();
+
+GameDimensions getGameDimensions();
 
-    isGameOver = false;
-    startGameTimer = 0;
-    score = 0;
-    startGameTimer = 0;
-    initialAngle = 0;
+void initFlock()
+{
+    initBirdFlock(flock, getGameDimensions(), flockBirdsCount, gameSeed);
+
+    RandomGenerator random;
+    seedRandomGenerator(random, gameSeed);
 
-    player.y = SCREEN_HEIGHT / 2;
-    player.sprite.textureBounds.x = SCREEN_WIDTH / 2;
-    player.sprite.textureBounds.y = SCREEN_HEIGHT / 2;
+    flockGenomes.assign(isBotPlaying ? flockBirdsCount : 0, botGenome);
+    flockFlapMargins.resize(flockBirdsCount);
+    flockFlaps.resize(flockBirdsCount);
+
+    for (BotGenome &genome : flockGenomes)
+    {
+        mutateBotGenome(genome, 0.1f, 0.2f, random);
+    }
 
-    simplePlayer.x = SCREEN_WIDTH / 2;
-    simplePlayer.y = SCREEN_HEIGHT / 2;
+    initBotBatch(flockBots, flockGenomes.data(), (int)flockGenomes.size());
 
-    gravity = 0;
-    pipes.clear();
+    // the autopilot flaps 10 pixels below the gap center, each bird picks its own margin around that.
+    for (float &margin : flockFlapMargins)
+    {
+        margin = 10 + (nextRandomFloat(random) * 2 - 1) * 30;
+    }
 }
 
-void quitGame()
+void restartFlock()
 {
-    Mix_FreeChunk(flapSound);
-    SDL_DestroyTexture(playerSprite.texture);
-    SDL_DestroyTexture(highScoreTexture);
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
-    Mix_CloseAudio();
-    IMG_Quit();
-    TTF_Quit();
-    SDL_Quit();
+    resetBirdFlock(flock);
+    initBotBatch(flockBots, flockGenomes.data(), (int)flockGenomes.size());
 }
 
-void handleEvents(float deltaTime)
+// fills flockFlaps, from the bot networks all at once or from each bird's autopilot margin.
+void decideFlockFlaps()
 {
-    SDL_Event event;
+    float inputs[BOT_INPUTS_COUNT];
 
-    while (SDL_PollEvent(&event))
+    for (int slot = 0; slot < flock.aliveCount; slot++)
     {
-        if (event.type == SDL_QUIT || event.key.keysym.sym == SDLK_ESCAPE)
-        {
-            quitGame();
-            exit(0);
-        }
-
-        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_k)
-        {
-            isSimpleGraphicsMode = !isSimpleGraphicsMode;
-        }
+        getBirdBotInputs(flock.pipes, flock.dimensions, flock.y[slot], flock.speed[slot], flock.impulse, inputs);
 
-        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_f)
+        if (isBotPlaying)
         {
-            isGamePaused = !isGamePaused;
-            Mix_PlayChannel(-1, gamePausedSound, 0);
+            setBotBatchInputs(flockBots, slot, inputs);
         }
-
-        if (isGameOver && (event.type == SDL_MOUSEBUTTONDOWN || (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_SPACE)))
+        else
         {
-            resetGame(player);
+            flockFlaps[slot] = flock.speed[slot] > 0 && inputs[3] * PIPE_GAP_HEIGHT < -flockFlapMargins[flock.birdIds[slot]];
         }
-        else if ((!isGameOver && event.type == SDL_MOUSEBUTTONDOWN) || (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_SPACE))
-        {
-            gravity = player.impulse * deltaTime;
-
-            shouldRotateUp = true;
-            upRotationTimer = 1;
-            downRotationTimer = 0;
-            initialAngle = -20;
+    }
 
-            Mix_PlayChannel(-1, flapSound, 0);
-        }
+    if (isBotPlaying)
+    {
+        runBotBatch(flockBots, flock.aliveCount);
+        std::copy(flockBots.flaps.begin(), flockBots.flaps.begin() + flock.aliveCount, flockFlaps.begin());
     }
 }
 
-void update(float deltaTime)
+void updateFlock(float deltaTime)
 {
-    startGameTimer += deltaTime;
+    decideFlockFlaps();
 
-    lastPipeSpawnTime += deltaTime;
-
-    if (lastPipeSpawnTime >= 2)
-    {
-        generatePipes();
-    }
+    int previousScore = flock.score;
+    int diedCount = stepBirdFlock(flock, flockFlaps.data(), deltaTime);
 
-    if (player.y < -player.sprite.textureBounds.h || (isSimpleGraphicsMode && simplePlayer.y < -simplePlayer.h))
+    if (isBotPlaying && diedCount > 0)
     {
-        isGameOver = true;
+        syncBotBatchSlots(flockBots, flock.birdIds.data(), flock.aliveCount);
     }
 
-    if (startGameTimer > 1)
+    if (flock.score > previousScore)
     {
-        player.y += gravity * deltaTime;
-        player.sprite.textureBounds.y = player.y;
-
-        simplePlayer.y = player.y;
-
-        gravity += player.gravityIncrement * deltaTime;
+        playSound(crossPipeSound);
     }
 
-    if (SDL_HasIntersection(&player.sprite.textureBounds, &groundCollisionBounds))
+    if (diedCount > 0 && flock.aliveCount == 0)
     {
-        isGameOver = true;
-        Mix_PlayChannel(-1, dieSound, 0);
+        playSound(dieSound);
     }
+}
 
-    for (Vector2 &groundPosition : groundPositions)
-    {
-        groundPosition.x -= 150 * deltaTime;
-
-        if (groundPosition.x < -groundSprite.textureBounds.w)
-        {
-            groundPosition.x = groundSprite.textureBounds.w * 3;
-        }
-    }
+void initEnv()
+{
+    createGameEnv(env, envInstancesCount, gameSeed, getGameDimensions(), tickRate, envWorkersCount);
+    envActions.assign(envInstancesCount, 0);
+    watchedEnvInstance = 0;
+}
 
-    for (auto actualPipe = pipes.begin(); actualPipe != pipes.end();)
+// the actions come from the observations alone, like a policy being trained: the bot, or the autopilot's rule.
+void decideEnvActions()
+{
+    for (int instance = 0; instance < env.instancesCount; instance++)
     {
-        actualPipe->x -= 150 * deltaTime;
-        actualPipe->sprite.textureBounds.x = actualPipe->x;
+        const float *observation = &env.observations[instance * GAME_ENV_OBSERVATION_SIZE];
 
-        if (SDL_HasIntersection(&player.sprite.textureBounds, &actualPipe->sprite.textureBounds))
+        if (isBotPlaying)
         {
-            isGameOver = true;
-            Mix_PlayChannel(-1, dieSound, 0);
-        }
-
-        if (!actualPipe->isBehind && player.sprite.textureBounds.x > actualPipe->sprite.textureBounds.x)
-        {
-            actualPipe->isBehind = true;
-
-            if (actualPipe->sprite.textureBounds.y < player.sprite.textureBounds.y)
-            {
-                score++;
-                Mix_PlayChannel(-1, crossPipeSound, 0);
-            }
-        }
-
-        if (actualPipe->sprite.textureBounds.x < -actualPipe->sprite.textureBounds.w)
-        {
-            actualPipe->isDestroyed = true;
-            pipes.erase(actualPipe);
+            envActions[instance] = isBotFlapping(botGenome, observation);
         }
         else
         {
-            actualPipe++;
+            envActions[instance] = observation[1] > 0 && observation[3] * PIPE_GAP_HEIGHT < -10;
         }
     }
 }
 
-void renderSprite(Sprite &sprite)
+// the shown game is the only one that plays sounds and whose runs count for the high score and the run history.
+void updateEnv()
 {
-    SDL_RenderCopy(renderer, sprite.texture, NULL, &sprite.textureBounds);
-}
+    decideEnvActions();
+    stepGameEnv(env, envActions.data());
 
-void render(float deltaTime)
-{
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
+    GameStepResult result = {};
 
-    if (!isSimpleGraphicsMode)
+    if (env.rewards[watchedEnvInstance] > 0)
     {
-        backgroundSprite.textureBounds.x = 0;
-        renderSprite(backgroundSprite);
-
-        backgroundSprite.textureBounds.x = backgroundSprite.textureBounds.w;
-        renderSprite(backgroundSprite);
-
-        backgroundSprite.textureBounds.x = backgroundSprite.textureBounds.w * 2;
-        renderSprite(backgroundSprite);
-
-        backgroundSprite.textureBounds.x = backgroundSprite.textureBounds.w * 3;
-        renderSprite(backgroundSprite);
-
-        groundSprite.textureBounds.x = 0;
-        renderSprite(groundSprite);
-
-        groundSprite.textureBounds.x = groundSprite.textureBounds.w;
-        renderSprite(groundSprite);
-
-        groundSprite.textureBounds.x = groundSprite.textureBounds.w * 2;
-        renderSprite(groundSprite);
-
-        groundSprite.textureBounds.x = groundSprite.textureBounds.w * 3;
-        renderSprite(groundSprite);
+        result.sounds |= GAME_SOUND_POINT;
     }
 
-    for (Pipe &pipe : pipes)
+    if (env.dones[watchedEnvInstance])
     {
-        if (!pipe.isDestroyed)
+        result.sounds |= GAME_SOUND_DIE;
+        result.isRunFinished = true;
+        result.finishedRunScore = env.episodeScores[watchedEnvInstance];
+        result.finishedRunTicks = env.episodeTicks[watchedEnvInstance];
+        result.finishedRunSeed = env.episodeSeeds[watchedEnvInstance];
+
+        if (result.finishedRunScore > game.highScore)
         {
-            if (isSimpleGraphicsMode)
-            {
-                SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                SDL_RenderFillRect(renderer, &pipe.sprite.textureBounds);
-            }
-            else
-            {
-                renderSprite(pipe.sprite);
-            }
+            game.highScore = result.finishedRunScore;
+            result.isNewHighScore = true;
         }
     }
 
-    if (highScore < 10)
+    handleGameStepResult(result);
+}
+
+void update(float deltaTime)
+{
+    if (isFlockMode)
     {
-        highScoreNumbers[highScore].textureBounds.x = 320;
-        renderSprite(highScoreNumbers[highScore]);
+        updateFlock(deltaTime);
+        return;
     }
-    else
-    {
-        int tens = (int)(highScore / 10);
-        int units = (int)(highScore % 10);
 
-        highScoreNumberTens[tens].textureBounds.x = 300;
-        highScoreNumbers[units].textureBounds.x = 320;
-
-        renderSprite(highScoreNumberTens[tens]);
-        renderSprite(highScoreNumbers[units]);
+    if (isEnvMode)
+    {
+        updateEnv();
+        return;
     }
 
-    if (score < 10)
+    if (isBotPlaying && !isGameWaiting(game))
     {
-        renderSprite(numbers[score]);
+        handleAutopilot();
     }
-    else
-    {
-        int tens = (int)(score / 10);
-        int units = (score % 10);
 
-        numberTens[tens].textureBounds.x = SCREEN_WIDTH / 2 - 20;
-
-        renderSprite(numberTens[tens]);
-        renderSprite(numbers[units]);
-    }
+    handleGameStepResult(stepGame(game, nullptr, 0, deltaTime));
+}
 
-    SDL_RenderCopy(renderer, highScoreTexture, NULL, &highScoreBounds);
+// runs on the thread that owns the simulation.
+void handleGameEvent(GameEvent event, Uint64 inputCounter)
+{
+    handledInputCounter = inputCounter;
 
-    if (isSimpleGraphicsMode)
+    switch (event)
     {
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        SDL_RenderFillRect(renderer, &groundCollisionBounds);
-    }
-    else
-    {
-        for (Vector2 &groundPosition : groundPositions)
+    case GAME_EVENT_PRESS:
+        if (isFlockMode)
         {
-            groundSprite.textureBounds.x = groundPosition.x;
-            renderSprite(groundSprite);
+            // the birds fly on their own, a press only restarts the flock once they're all gone.
+            if (flock.aliveCount == 0)
+            {
+                restartFlock();
+            }
+        }
+        else if (isEnvMode)
+        {
+            // the games play on their own, a press shows the next one.
+            watchedEnvInstance = (watchedEnvInstance + 1) % env.instancesCount;
         }
+        else
+        {
+            applyInput(game.isGameOver ? INPUT_RESET : INPUT_FLAP);
+        }
+        break;
+    case GAME_EVENT_PAUSE:
+        applyInput(INPUT_PAUSE);
+        break;
+    case GAME_EVENT_TOGGLE_SIMPLE_GRAPHICS:
+        game.isSimpleGraphicsMode = !game.isSimpleGraphicsMode;
+        break;
     }
 
-    if (isGameOver)
+    handledInputCounter = 0;
+}
+
+void sendGameEvent(GameEvent event, Uint64 inputCounter)
+{
+    if (simulationThread == nullptr)
     {
-        renderSprite(startGameSprite);
+        handleGameEvent(event, inputCounter);
     }
-
-    if (!isSimpleGraphicsMode)
+    else if (!pushQueuedEvent(gameEvents, event, inputCounter))
     {
-        /* code */
-        // To flip my texture whether horizontal or vertical this are the values to use.
-        // SDL_FLIP_NONE = 0x00000000,     /**< Do not flip */
-        // SDL_FLIP_HORIZONTAL = 0x00000001,    /**< flip horizontally */
-        // SDL_FLIP_VERTICAL = 0x00000002     /**< flip vertically */
+        printf("Dropped a game event, the simulation thread is falling behind\n");
+    }
+}
 
-        SDL_RenderCopyEx(renderer, birdSprites.texture, &birdsBounds, &player.sprite.textureBounds, initialAngle, NULL, SDL_FLIP_NONE);
+// the event waited in SDL's queue since its timestamp, in SDL_GetTicks() milliseconds.
+Uint64 getEventCounter(const SDL_Event &event)
+{
+    Uint64 counter = SDL_GetPerformanceCounter();
+    Sint32 waitedMilliseconds = SDL_max((Sint32)(SDL_GetTicks() - event.common.timestamp), 0);
 
-        if (startGameTimer > 1)
-        {
-            downRotationTimer += deltaTime;
+    return counter - SDL_min(counter, (Uint64)waitedMilliseconds * SDL_GetPerformanceFrequency() / 1000);
+}
 
-            if (downRotationTimer < 0.5f)
-            {
-                SDL_RenderCopyEx(renderer, birdSprites.texture, &birdsBounds, &player.sprite.textureBounds, initialAngle, NULL, SDL_FLIP_NONE);
-            }
+void handleEvents()
+{
+    SDL_Event event;
 
-            if (shouldRotateUp)
-            {
-                if (upRotationTimer > 0)
-                {
-                    upRotationTimer -= deltaTime;
-                }
+    while (SDL_PollEvent(&event))
+    {
+        Uint64 inputCounter = getEventCounter(event);
 
-                if (upRotationTimer <= 0)
-                {
-                    shouldRotateUp = false;
-                }
+        if (event.type == SDL_QUIT || event.key.keysym.sym == SDLK_ESCAPE)
+        {
+            quitGame();
+            exit(0);
+        }
 
-                SDL_RenderCopyEx(renderer, birdSprites.texture, &birdsBounds, &player.sprite.textureBounds, initialAngle, NULL, SDL_FLIP_NONE);
-            }
+        // the contents of render targets are lost when the device is reset.
+        if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET)
+        {
+            markRenderLayerDirty(backgroundLayer);
+            markRenderLayerDirty(hudLayer);
+        }
 
-            if (downRotationTimer > 0.5f)
-            {
-                if (initialAngle <= 90 && !isGameOver && !isGamePaused)
-                {
-                    initialAngle += 2;
-                }
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_k)
+        {
+            sendGameEvent(GAME_EVENT_TOGGLE_SIMPLE_GRAPHICS, inputCounter);
+        }
 
-                SDL_RenderCopyEx(renderer, birdSprites.texture, &birdsBounds, &player.sprite.textureBounds, initialAngle, NULL, SDL_FLIP_NONE);
-            }
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_p)
+        {
+            isProfilerOverlayVisible = !isProfilerOverlayVisible;
+            profilerRefreshTimer = 0;
         }
-        else
+
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_f)
         {
-            SDL_RenderCopyEx(renderer, birdSprites.texture, &birdsBounds, &player.sprite.textureBounds, initialAngle, NULL, SDL_FLIP_NONE);
+            sendGameEvent(GAME_EVENT_PAUSE, inputCounter);
         }
-    }
-    else
-    {
-        SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-        SDL_RenderFillRect(renderer, &simplePlayer);
-    }
 
-    SDL_RenderPresent(renderer);
+        if (event.type == SDL_MOUSEBUTTONDOWN || (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_SPACE))
+        {
+            sendGameEvent(GAME_EVENT_PRESS, inputCounter);
+        }
+    }
 }
 
-void loadNumbersSprites()
+// input source for headless runs: flap whenever the bird falls below the center of the next gap.
+bool isAutopilotFlapping()
 {
-    std::string baseString = "res/sprites/";
-    std::string fileExtension = ".png";
+    return isBotPlaying ? shouldBotFlap(botGenome, game) : shouldAutopilotFlap(game);
+}
 
-    for (int i = 0; i < 10; i++)
+void handleAutopilot()
+{
+    if (isAutopilotFlapping())
     {
-        std::string completeString = baseString + std::to_string(i) + fileExtension;
-
-        Sprite numberSprite = loadSprite(renderer, completeString.c_str(), SCREEN_WIDTH / 2, 30);
-
-        numbers.push_back(numberSprite);
-        numberTens.push_back(numberSprite);
-
-        highScoreNumbers.push_back(numberSprite);
-        highScoreNumberTens.push_back(numberSprite);
+        applyInput(INPUT_FLAP);
     }
 }
 
-// the rule of reference vs value also apply to primitive datatypes.
-void makeBirdAnimation(int &framesCounter, int &currentFrame, SDL_Rect &birdsBounds)
+void renderSprite(Sprite &sprite)
 {
-    int framesSpeed = 6;
+    drawSprite(spriteBatch, sprite);
+}
 
-    framesCounter++;
+const char *numberFilePaths[10] = {
+    "res/sprites/0.png", "res/sprites/1.png", "res/sprites/2.png", "res/sprites/3.png", "res/sprites/4.png",
+    "res/sprites/5.png", "res/sprites/6.png", "res/sprites/7.png", "res/sprites/8.png", "res/sprites/9.png"};
 
-    if (framesCounter >= (60 / framesSpeed))
-    {
-        framesCounter = 0;
-        currentFrame++;
+Sprite numberSprites[10];
 
-        if (currentFrame > 2)
-            currentFrame = 0;
+int measureNumber(int number)
+{
+    std::string digits = std::to_string(number);
 
-        birdsBounds.x = currentFrame * birdsBounds.w;
+    int width = 0;
+
+    for (char digit : digits)
+    {
+        width += numberSprites[digit - '0'].textureBounds.w;
     }
+
+    return width;
 }
 
-int main(int argc, char *args[])
+// any number of digits, each digit sprite advances by its own width.
+void renderNumber(int number, int x, int y)
 {
-    window = SDL_CreateWindow("My Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    std::string digits = std::to_string(number);
 
-    if (startSDL(window, renderer) > 0)
+    for (char digit : digits)
     {
-        return 1;
-    }
+        Sprite digitSprite = numberSprites[digit - '0'];
+        digitSprite.textureBounds.x = x;
+        digitSprite.textureBounds.y = y;
 
-    fontSquare = TTF_OpenFont("res/fonts/square_sans_serif_7.ttf", 36);
+        renderSprite(digitSprite);
 
-    updateTextureText(highScoreTexture, "High Score: ", fontSquare, renderer);
+        x += digitSprite.textureBounds.w;
+    }
+}
 
-    SDL_QueryTexture(highScoreTexture, NULL, NULL, &highScoreBounds.w, &highScoreBounds.h);
-    highScoreBounds.x = 20;
-    highScoreBounds.y = 30;
+void renderBackground()
+{
+    backgroundSprite.textureBounds.x = 0;
+    renderSprite(backgroundSprite);
 
-    gamePausedSound = loadSound("res/sounds/magic.wav");
-    flapSound = loadSound("res/sounds/wing.wav");
-    pauseSound = loadSound("res/sounds/magic.wav");
-    dieSound = loadSound("res/sounds/die.wav");
-    crossPipeSound = loadSound("res/sounds/point.wav");
+    backgroundSprite.textureBounds.x = backgroundSprite.textureBounds.w;
+    renderSprite(backgroundSprite);
 
-    highScore = loadHighScore();
+    backgroundSprite.textureBounds.x = backgroundSprite.textureBounds.w * 2;
+    renderSprite(backgroundSprite);
 
-    upPipeSprite = loadSprite(renderer, "res/sprites/pipe-green-180.png", SCREEN_WIDTH / 2, -220);
-    downPipeSprite = loadSprite(renderer, "res/sprites/pipe-green.png", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+    backgroundSprite.textureBounds.x = backgroundSprite.textureBounds.w * 3;
+    renderSprite(backgroundSprite);
 
-    startGameSprite = loadSprite(renderer, "res/sprites/message.png", SCREEN_WIDTH / 2 - 75, 103);
-    backgroundSprite = loadSprite(renderer, "res/sprites/background-day.png", 0, 0);
+    groundSprite.textureBounds.x = 0;
+    renderSprite(groundSprite);
 
-    groundSprite = loadSprite(renderer, "res/sprites/base.png", 0, 0);
+    groundSprite.textureBounds.x = groundSprite.textureBounds.w;
+    renderSprite(groundSprite);
 
-    groundYPosition = SCREEN_HEIGHT - groundSprite.textureBounds.h;
+    groundSprite.textureBounds.x = groundSprite.textureBounds.w * 2;
+    renderSprite(groundSprite);
 
-    groundSprite.textureBounds.y = groundYPosition;
+    groundSprite.textureBounds.x = groundSprite.textureBounds.w * 3;
+    renderSprite(groundSprite);
+}
 
-    groundCollisionBounds = {0, (int)groundYPosition, SCREEN_WIDTH, groundSprite.textureBounds.h};
+const int HUD_X = 20;
+const int HUD_Y = 30;
+// where the high score digits start, relative to the label.
+const int HUD_HIGH_SCORE_OFFSET = 280;
 
-    groundPositions.push_back({0, groundYPosition});
-    groundPositions.push_back({(float)groundSprite.textureBounds.w, groundYPosition});
-    groundPositions.push_back({(float)groundSprite.textureBounds.w * 2, groundYPosition});
-    groundPositions.push_back({(float)groundSprite.textureBounds.w * 3, groundYPosition});
+void renderHud(int x, int y, int highScore)
+{
+    drawText(spriteBatch, hudGlyphs, "High Score: ", x, y);
 
-    playerSprite = loadSprite(renderer, "res/sprites/yellowbird-midflap.png", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+    renderNumber(highScore, x + HUD_HIGH_SCORE_OFFSET, y);
+}
 
-    player = Player{SCREEN_HEIGHT / 2, playerSprite, -10000, 400};
+void initRenderLayers()
+{
+    initRenderLayer(renderer, backgroundLayer, {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}, false);
 
-    loadNumbersSprites();
+    // room for any high score, as many of the widest digit as INT_MAX has digits.
+    int widestDigitWidth = 0;
 
-    birdSprites = loadSprite(renderer, "res/sprites/yellow-bird.png", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
-    birdsBounds = {0, 0, birdSprites.textureBounds.w / 3, birdSprites.textureBounds.h};
+    for (const Sprite &numberSprite : numberSprites)
+    {
+        widestDigitWidth = std::max(widestDigitWidth, numberSprite.textureBounds.w);
+    }
 
-    int framesCounter = 0;
-    int currentFrame = 0;
+    int hudWidth = HUD_HIGH_SCORE_OFFSET + widestDigitWidth * (int)std::to_string(INT_MAX).size();
+    int hudHeight = std::max(hudGlyphs.lineHeight, numberSprites[0].textureBounds.h);
 
-    Uint32 previousFrameTime = SDL_GetTicks();
-    Uint32 currentFrameTime = previousFrameTime;
-    float deltaTime = 0.0f;
+    initRenderLayer(renderer, hudLayer, {HUD_X, HUD_Y, hudWidth, hudHeight}, true);
+}
 
-    srand(time(NULL));
+// the high score the hud layer was composed with.
+int hudLayerHighScore = -1;
 
-    while (true)
+// done before anything is drawn on screen, switching render targets mid frame isn't guaranteed to keep the back buffer.
+void updateRenderLayers(const RenderSnapshot &snapshot)
+{
+    if (snapshot.highScore != hudLayerHighScore)
     {
-        currentFrameTime = SDL_GetTicks();
-        deltaTime = (currentFrameTime - previousFrameTime) / 1000.0f;
-        previousFrameTime = currentFrameTime;
+        markRenderLayerDirty(hudLayer);
+        hudLayerHighScore = snapshot.highScore;
+    }
 
-        handleEvents(deltaTime);
+    if (backgroundLayer.texture != nullptr && backgroundLayer.isDirty)
+    {
+        beginRenderLayer(spriteBatch, backgroundLayer);
+        renderBackground();
+        endRenderLayer(spriteBatch, backgroundLayer);
+    }
 
-        if (!isGameOver && !isGamePaused)
+    if (hudLayer.texture != nullptr && hudLayer.isDirty)
+    {
+        beginRenderLayer(spriteBatch, hudLayer);
+        renderHud(0, 0, snapshot.highScore);
+        endRenderLayer(spriteBatch, hudLayer);
+    }
+}
+
+void captureRenderSnapshot(RenderSnapshot &snapshot)
+{
+    // in env mode the game only holds the high score and the pause, the shown instance is drawn.
+    const GameState &shownGame = isEnvMode ? env.games[watchedEnvInstance] : game;
+
+    snapshot.playerY = shownGame.playerY;
+    snapshot.previousPlayerY = shownGame.previousPlayerY;
+    snapshot.angle = shownGame.angle;
+    snapshot.previousAngle = shownGame.previousAngle;
+
+    const PipePairs &pipes = isFlockMode ? flock.pipes : shownGame.pipes;
+
+    snapshot.pipesCount = pipes.count;
+
+    for (int i = 0; i < pipes.count; i++)
+    {
+        int index = getPipePairIndex(pipes, i);
+
+        snapshot.pipesX[i] = pipes.x[index];
+        snapshot.pipesPreviousX[i] = pipes.previousX[index];
+        snapshot.pipesGapCenter[i] = pipes.gapCenter[index];
+        snapshot.pipesGapHeight[i] = pipes.gapHeight[index];
+    }
+
+    for (int i = 0; i < GROUND_TILES_COUNT; i++)
+    {
+        snapshot.groundPositions[i] = isFlockMode ? flock.groundPositions[i] : shownGame.groundPositions[i];
+        snapshot.previousGroundPositions[i] = isFlockMode ? flock.previousGroundPositions[i] : shownGame.previousGroundPositions[i];
+    }
+
+    snapshot.flockAliveCount = isFlockMode ? flock.aliveCount : 0;
+
+    if (isFlockMode)
+    {
+        // the vectors keep their capacity, so after the first ticks this doesn't allocate.
+        snapshot.flockY.assign(flock.y.begin(), flock.y.begin() + flock.aliveCount);
+        snapshot.flockPreviousY.assign(flock.previousY.begin(), flock.previousY.begin() + flock.aliveCount);
+        snapshot.flockAngle.assign(flock.angle.begin(), flock.angle.begin() + flock.aliveCount);
+        snapshot.flockPreviousAngle.assign(flock.previousAngle.begin(), flock.previousAngle.begin() + flock.aliveCount);
+    }
+
+    snapshot.score = isFlockMode ? flock.score : shownGame.score;
+    snapshot.highScore = game.highScore;
+    snapshot.isGameOver = isFlockMode ? flock.aliveCount == 0 : shownGame.isGameOver;
+    snapshot.isGamePaused = game.isGamePaused;
+    snapshot.isSimpleGraphicsMode = game.isSimpleGraphicsMode;
+    snapshot.tickCounter = SDL_GetPerformanceCounter();
+}
+
+// every living bird goes through the sprite batch, so with the atlas they're a single draw call.
+// past FLOCK_DETAILED_BIRDS_LIMIT the birds are counted per row instead, and each occupied row
+// is one quad shaded by how many birds are in it.
+void renderFlock(const RenderSnapshot &snapshot, float alpha)
+{
+    if (snapshot.flockAliveCount > FLOCK_DETAILED_BIRDS_LIMIT)
+    {
+        const int rowsCount = SCREEN_HEIGHT / FLOCK_BAND_ROW_HEIGHT;
+        int rowBirds[rowsCount] = {};
+
+        for (int i = 0; i < snapshot.flockAliveCount; i++)
+        {
+            int row = (int)(snapshot.flockY[i] + playerSprite.textureBounds.h / 2) / FLOCK_BAND_ROW_HEIGHT;
+            rowBirds[SDL_clamp(row, 0, rowsCount - 1)]++;
+        }
+
+        for (int row = 0; row < rowsCount; row++)
+        {
+            if (rowBirds[row] > 0)
+            {
+                SDL_Rect rowBounds = {SCREEN_WIDTH / 2, row * FLOCK_BAND_ROW_HEIGHT, playerSprite.textureBounds.w, FLOCK_BAND_ROW_HEIGHT};
+                Uint8 shade = SDL_min(255, 95 + rowBirds[row]);
+
+                drawFilledQuad(spriteBatch, rowBounds, {shade, shade, 0, 255});
+            }
+        }
+
+        return;
+    }
+
+    for (int i = 0; i < snapshot.flockAliveCount; i++)
+    {
+        float birdY = interpolate(snapshot.flockPreviousY[i], snapshot.flockY[i], alpha);
+
+        if (snapshot.isSimpleGraphicsMode)
+        {
+            SDL_Rect birdBounds = {SCREEN_WIDTH / 2, (int)birdY, SIMPLE_BIRD_WIDTH, SIMPLE_BIRD_HEIGHT};
+
+            drawFilledQuad(spriteBatch, birdBounds, {255, 255, 0, 255});
+        }
+        else
+        {
+            float angle = interpolate(snapshot.flockPreviousAngle[i], snapshot.flockAngle[i], alpha);
+            SDL_FRect birdDestination = {SCREEN_WIDTH / 2, (float)(int)birdY, (float)playerSprite.textureBounds.w,
+                                         (float)playerSprite.textureBounds.h};
+
+            drawTexturedQuad(spriteBatch, birdSprites.texture, birdsBounds, birdDestination, angle);
+        }
+    }
+}
+
+// alpha is how far the current frame is between the previous and the current tick.
+void render(const RenderSnapshot &snapshot, float alpha)
+{
+    updateRenderLayers(snapshot);
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    beginSpriteBatch(spriteBatch);
+
+    if (!snapshot.isSimpleGraphicsMode)
+    {
+        if (backgroundLayer.texture != nullptr)
+        {
+            drawRenderLayer(spriteBatch, backgroundLayer);
+        }
+        else
+        {
+            renderBackground();
+        }
+    }
+
+    for (int i = 0; i < snapshot.pipesCount; i++)
+    {
+        int pipeX = interpolate(snapshot.pipesPreviousX[i], snapshot.pipesX[i], alpha);
+        float halfGap = snapshot.pipesGapHeight[i] / 2;
+
+        Sprite upSprite = upPipeSprite;
+        upSprite.textureBounds.x = pipeX;
+        upSprite.textureBounds.y = snapshot.pipesGapCenter[i] - halfGap - upPipeSprite.textureBounds.h;
+
+        Sprite downSprite = downPipeSprite;
+        downSprite.textureBounds.x = pipeX;
+        downSprite.textureBounds.y = snapshot.pipesGapCenter[i] + halfGap;
+
+        if (snapshot.isSimpleGraphicsMode)
+        {
+            drawFilledQuad(spriteBatch, upSprite.textureBounds, {0, 255, 0, 255});
+            drawFilledQuad(spriteBatch, downSprite.textureBounds, {0, 255, 0, 255});
+        }
+        else
+        {
+            renderSprite(upSprite);
+            renderSprite(downSprite);
+        }
+    }
+
+    int scoreWidth = measureNumber(snapshot.score);
+    renderNumber(snapshot.score, (SCREEN_WIDTH - scoreWidth) / 2 + 10, 30);
+
+    if (snapshot.isSimpleGraphicsMode)
+    {
+        SDL_Rect groundBounds = {0, groundSprite.textureBounds.y, SCREEN_WIDTH, groundSprite.textureBounds.h};
+
+        drawFilledQuad(spriteBatch, groundBounds, {255, 255, 255, 255});
+    }
+    else
+    {
+        for (int i = 0; i < GROUND_TILES_COUNT; i++)
+        {
+            float previousX = snapshot.previousGroundPositions[i].x;
+
+            // don't interpolate across the jump back to the right side.
+            if (previousX < snapshot.groundPositions[i].x)
+            {
+                previousX = snapshot.groundPositions[i].x;
+            }
+
+            groundSprite.textureBounds.x = interpolate(previousX, snapshot.groundPositions[i].x, alpha);
+            renderSprite(groundSprite);
+        }
+    }
+
+    if (snapshot.isGameOver)
+    {
+        renderSprite(startGameSprite);
+    }
+
+    float playerY = interpolate(snapshot.previousPlayerY, snapshot.playerY, alpha);
+
+    if (isFlockMode)
+    {
+        renderFlock(snapshot, alpha);
+    }
+    else if (!snapshot.isSimpleGraphicsMode)
+    {
+        // To flip my texture whether horizontal or vertical this are the values to use.
+        // SDL_FLIP_NONE = 0x00000000,     /**< Do not flip */
+        // SDL_FLIP_HORIZONTAL = 0x00000001,    /**< flip horizontally */
+        // SDL_FLIP_VERTICAL = 0x00000002     /**< flip vertically */
+
+        // the rotation timers are advanced by updateBirdRotation(), render only reads them.
+        SDL_Rect playerBounds = playerSprite.textureBounds;
+        playerBounds.y = playerY;
+
+        float angle = interpolate(snapshot.previousAngle, snapshot.angle, alpha);
+
+        SDL_FRect playerDestination = {(float)playerBounds.x, (float)playerBounds.y, (float)playerBounds.w, (float)playerBounds.h};
+
+        drawTexturedQuad(spriteBatch, birdSprites.texture, birdsBounds, playerDestination, angle);
+    }
+    else
+    {
+        SDL_Rect simplePlayerBounds = {SCREEN_WIDTH / 2, (int)playerY, SIMPLE_BIRD_WIDTH, SIMPLE_BIRD_HEIGHT};
+
+        drawFilledQuad(spriteBatch, simplePlayerBounds, {255, 255, 0, 255});
+    }
+
+    // drawn last so the atlas sprites above share a single draw call, it doesn't overlap the bird or the message.
+    if (hudLayer.texture != nullptr)
+    {
+        drawRenderLayer(spriteBatch, hudLayer);
+    }
+    else
+    {
+        renderHud(HUD_X, HUD_Y, snapshot.highScore);
+    }
+
+    flushSpriteBatch(spriteBatch);
+}
+
+void updateProfilerOverlayText(int drawCalls)
+{
+    // refreshed a few times per second so the numbers stay readable, drawing them is just glyph quads.
+    profilerLines[0] = "phase     cur    p50    p99    max (ms)";
+
+    for (int phase = 0; phase < PHASE_COUNT; phase++)
+    {
+        profilerLines[phase + 1] = formatPhaseStats(frameProfiler, (FramePhase)phase);
+    }
+
+    profilerLines[PHASE_COUNT + 1] = "draw calls: " + std::to_string(drawCalls);
+}
+
+void renderProfilerOverlay(float deltaTime)
+{
+    // the draw calls of the game itself, before the overlay adds its own.
+    int drawCalls = spriteBatch.drawCalls;
+
+    profilerRefreshTimer -= deltaTime;
+
+    if (profilerRefreshTimer <= 0)
+    {
+        updateProfilerOverlayText(drawCalls);
+        profilerRefreshTimer = 0.25f;
+    }
+
+    SDL_Rect backgroundBounds = {SCREEN_WIDTH - 430, 80, 420, PROFILER_OVERLAY_LINES * 16 + 20};
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    drawFilledQuad(spriteBatch, backgroundBounds, {0, 0, 0, 160});
+    flushSpriteBatch(spriteBatch);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    for (int i = 0; i < PROFILER_OVERLAY_LINES; i++)
+    {
+        drawText(spriteBatch, profilerGlyphs, profilerLines[i].c_str(), SCREEN_WIDTH - 420, 90 + i * 16);
+    }
+
+    flushSpriteBatch(spriteBatch);
+}
+
+void renderLoadingScreen(float progress)
+{
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    SDL_Rect barBounds = {SCREEN_WIDTH / 4, SCREEN_HEIGHT / 2 - 10, SCREEN_WIDTH / 2, 20};
+    SDL_Rect progressBounds = {barBounds.x, barBounds.y, (int)(barBounds.w * progress), barBounds.h};
+
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDrawRect(renderer, &barBounds);
+    SDL_RenderFillRect(renderer, &progressBounds);
+
+    SDL_RenderPresent(renderer);
+}
+
+std::vector<AtlasEntry> makeAtlasEntries()
+{
+    std::vector<AtlasEntry> atlasEntries = {
+        {"res/sprites/pipe-green-180.png", SCREEN_WIDTH / 2, -220, &upPipeSprite},
+        {"res/sprites/pipe-green.png", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, &downPipeSprite},
+        {"res/sprites/message.png", SCREEN_WIDTH / 2 - 75, 103, &startGameSprite},
+        {"res/sprites/background-day.png", 0, 0, &backgroundSprite},
+        {"res/sprites/base.png", 0, 0, &groundSprite},
+        {"res/sprites/yellowbird-midflap.png", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, &playerSprite},
+        {"res/sprites/yellow-bird.png", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, &birdSprites}};
+
+    for (int i = 0; i < 10; i++)
+    {
+        atlasEntries.push_back({numberFilePaths[i], SCREEN_WIDTH / 2, 30, &numberSprites[i]});
+    }
+
+    return atlasEntries;
+}
+
+// the engine copies the samples into its own arena.
+int addEngineSound(const AssetRequest &request, int priority)
+{
+    return addEngineSound(audioEngine, request.samples, request.samplesLength, priority);
+}
+
+// decodes every sprite and sound on worker threads while the main thread keeps presenting a loading screen,
+// then uploads the atlas and creates the sound chunks.
+void loadAssets(Uint64 startCounter)
+{
+    std::vector<AtlasEntry> atlasEntries = makeAtlasEntries();
+
+    for (AtlasEntry &atlasEntry : atlasEntries)
+    {
+        addAssetRequest(assetsLoader, atlasEntry.filePath, ASSET_IMAGE);
+    }
+
+    int magicSoundRequest = addAssetRequest(assetsLoader, "res/sounds/magic.wav", ASSET_SOUND);
+    int flapSoundRequest = addAssetRequest(assetsLoader, "res/sounds/wing.wav", ASSET_SOUND);
+    int dieSoundRequest = addAssetRequest(assetsLoader, "res/sounds/die.wav", ASSET_SOUND);
+    int crossPipeSoundRequest = addAssetRequest(assetsLoader, "res/sounds/point.wav", ASSET_SOUND);
+
+    startAsyncAssetsLoader(assetsLoader, 0);
+
+    bool isFirstFrame = true;
+
+    while (!isAsyncAssetsLoaderDone(assetsLoader))
+    {
+        SDL_Event event;
+
+        while (SDL_PollEvent(&event))
+        {
+            if (event.type == SDL_QUIT)
+            {
+                quitGame();
+                exit(0);
+            }
+        }
+
+        renderLoadingScreen(getAsyncAssetsLoaderProgress(assetsLoader));
+
+        if (isFirstFrame)
+        {
+            std::cout << "time to first frame: " << (double)(SDL_GetPerformanceCounter() - startCounter) * 1000 / SDL_GetPerformanceFrequency() << " ms\n";
+            isFirstFrame = false;
+        }
+    }
+
+    finishAsyncAssetsLoader(assetsLoader);
+
+    std::vector<SDL_Surface *> surfaces;
+
+    for (size_t i = 0; i < atlasEntries.size(); i++)
+    {
+        surfaces.push_back(assetsLoader.requests[i].surface);
+    }
+
+    bool isAtlasLoaded = buildTextureAtlas(renderer, atlasEntries.data(), surfaces.data(), atlasEntries.size(), textureAtlas);
+
+    // one texture per sprite is slower to draw but still works.
+    if (!isAtlasLoaded)
+    {
+        for (AtlasEntry &atlasEntry : atlasEntries)
+        {
+            *atlasEntry.sprite = loadSprite(renderer, atlasEntry.filePath, atlasEntry.positionX, atlasEntry.positionY);
+        }
+    }
+
+    // the pixels live in the atlas texture now.
+    for (size_t i = 0; i < atlasEntries.size(); i++)
+    {
+        SDL_FreeSurface(assetsLoader.requests[i].surface);
+        assetsLoader.requests[i].surface = nullptr;
+    }
+
+    if (audioEngine.device != 0)
+    {
+        // the death sound is the last to be cut off when every voice is busy, and flaps the first.
+        int magicSound = addEngineSound(assetsLoader.requests[magicSoundRequest], 2);
+
+        gamePausedSound.engineSound = magicSound;
+        pauseSound.engineSound = magicSound;
+        flapSound.engineSound = addEngineSound(assetsLoader.requests[flapSoundRequest], 1);
+        dieSound.engineSound = addEngineSound(assetsLoader.requests[dieSoundRequest], 3);
+        crossPipeSound.engineSound = addEngineSound(assetsLoader.requests[crossPipeSoundRequest], 2);
+
+        startAudioEngine(audioEngine);
+    }
+    else
+    {
+        gamePausedSound.chunk = createSoundChunk(assetsLoader.requests[magicSoundRequest]);
+        pauseSound.chunk = createSoundChunk(assetsLoader.requests[magicSoundRequest]);
+        flapSound.chunk = createSoundChunk(assetsLoader.requests[flapSoundRequest]);
+        dieSound.chunk = createSoundChunk(assetsLoader.requests[dieSoundRequest]);
+        crossPipeSound.chunk = createSoundChunk(assetsLoader.requests[crossPipeSoundRequest]);
+    }
+
+    std::cout << "assets loaded in: " << (double)(SDL_GetPerformanceCounter() - startCounter) * 1000 / SDL_GetPerformanceFrequency() << " ms" << std::endl;
+}
+
+// the rule of reference vs value also apply to primitive datatypes.
+void makeBirdAnimation(float deltaTime, float &animationTimer, int &currentFrame, SDL_Rect &birdsBounds)
+{
+    int framesSpeed = 6;
+
+    animationTimer += deltaTime;
+
+    if (animationTimer >= 1.0f / framesSpeed)
+    {
+        animationTimer = 0;
+        currentFrame++;
+
+        if (currentFrame > 2)
+            currentFrame = 0;
+
+        birdsBounds.x = birdSprites.sourceBounds.x + currentFrame * birdsBounds.w;
+    }
+}
+
+GameDimensions getGameDimensions()
+{
+    return {playerSprite.textureBounds.w, playerSprite.textureBounds.h, upPipeSprite.textureBounds.w, upPipeSprite.textureBounds.h,
+            groundSprite.textureBounds.w, groundSprite.textureBounds.h};
+}
+
+void initializeWorld()
+{
+    groundSprite.textureBounds.y = SCREEN_HEIGHT - groundSprite.textureBounds.h;
+
+    if (gameSeed == 0)
+    {
+        gameSeed = makeRandomSeed();
+    }
+
+    initGameState(game, getGameDimensions(), gameSeed);
+}
+
+int loadHeadlessSprites()
+{
+    if (!IMG_Init(IMG_INIT_PNG))
+    {
+        std::cout << "SDL_image crashed. Error: " << SDL_GetError();
+        return 1;
+    }
+
+    // only the sizes of these sprites matter to the simulation, so no textures are created.
+    upPipeSprite = loadSpriteBounds("res/sprites/pipe-green-180.png", SCREEN_WIDTH / 2, -220);
+    downPipeSprite = loadSpriteBounds("res/sprites/pipe-green.png", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+    groundSprite = loadSpriteBounds("res/sprites/base.png", 0, 0);
+    playerSprite = loadSpriteBounds("res/sprites/yellowbird-midflap.png", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+
+    return 0;
+}
+
+// steps the simulation with a fixed delta time and no window, renderer, fonts or audio, as fast as the cpu allows.
+int runHeadless(long long totalTicks)
+{
+    if (loadHeadlessSprites() > 0)
+    {
+        return 1;
+    }
+
+    initializeWorld();
+
+    std::cout << "seed: " << gameSeed << "\n";
+
+    const float deltaTime = 1.0f / tickRate;
+
+    long long gamesPlayed = 0;
+    int bestScore = 0;
+
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    for (long long tick = 0; tick < totalTicks; tick++)
+    {
+        InputAction input;
+        int inputsCount = 0;
+
+        if (game.isGameOver)
+        {
+            bestScore = std::max(bestScore, game.score);
+            gamesPlayed++;
+
+            input = INPUT_RESET;
+            inputsCount = 1;
+        }
+        else if (isAutopilotFlapping())
+        {
+            input = INPUT_FLAP;
+            inputsCount = 1;
+        }
+
+        stepRecordedGame(&input, inputsCount, deltaTime);
+    }
+
+    double elapsedSeconds = (double)(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
+
+    std::cout << "headless ticks: " << totalTicks << "\n";
+    std::cout << "elapsed seconds: " << elapsedSeconds << "\n";
+    std::cout << "ticks per second: " << (elapsedSeconds > 0 ? totalTicks / elapsedSeconds : 0) << "\n";
+    std::cout << "games played: " << gamesPlayed << "\n";
+    std::cout << "best score: " << std::max(bestScore, game.score) << std::endl;
+
+    quitGame();
+
+    return 0;
+}
+
+typedef struct
+{
+    GameState game;
+    long long ticks;
+    long long gamesPlayed;
+    int bestScore;
+} HeadlessGame;
+
+int runHeadlessGame(void *data)
+{
+    HeadlessGame &headlessGame = *(HeadlessGame *)data;
+    GameState &game = headlessGame.game;
+
+    const float deltaTime = 1.0f / tickRate;
+
+    for (long long tick = 0; tick < headlessGame.ticks; tick++)
+    {
+        InputAction input = game.isGameOver ? INPUT_RESET : INPUT_FLAP;
+        int inputsCount = game.isGameOver || shouldAutopilotFlap(game) ? 1 : 0;
+
+        if (game.isGameOver)
+        {
+            headlessGame.bestScore = std::max(headlessGame.bestScore, game.score);
+            headlessGame.gamesPlayed++;
+        }
+
+        stepGame(game, &input, inputsCount, deltaTime);
+    }
+
+    headlessGame.bestScore = std::max(headlessGame.bestScore, game.score);
+
+    return 0;
+}
+
+// steps the flock as fast as the cpu allows and restarts it whenever every bird is dead.
+int runHeadlessFlock(long long totalTicks)
+{
+    if (loadHeadlessSprites() > 0)
+    {
+        return 1;
+    }
+
+    initializeWorld();
+    initFlock();
+
+    std::cout << "seed: " << gameSeed << ", birds: " << flockBirdsCount << "\n";
+    std::cout << "collision kernel: " << getBirdCollisionKernelName(getBirdCollisionKernel()) << "\n";
+
+    if (isBotPlaying)
+    {
+        std::cout << "inference kernel: " << getBotBatchKernelName(getBotBatchKernel()) << "\n";
+    }
+
+    const float deltaTime = 1.0f / tickRate;
+
+    long long flocksFlown = 0;
+    long long birdTicks = 0;
+    int bestScore = 0;
+
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    for (long long tick = 0; tick < totalTicks; tick++)
+    {
+        if (flock.aliveCount == 0)
+        {
+            bestScore = std::max(bestScore, flock.score);
+            flocksFlown++;
+
+            restartFlock();
+        }
+
+        birdTicks += flock.aliveCount;
+
+        updateFlock(deltaTime);
+    }
+
+    double elapsedSeconds = (double)(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
+
+    std::cout << "ticks: " << totalTicks << "\n";
+    std::cout << "elapsed seconds: " << elapsedSeconds << "\n";
+    std::cout << "bird ticks per second: " << (elapsedSeconds > 0 ? birdTicks / elapsedSeconds : 0) << "\n";
+    std::cout << "flocks flown: " << flocksFlown << "\n";
+    std::cout << "best score: " << std::max(bestScore, flock.score) << std::endl;
+
+    quitGame();
+
+    return 0;
+}
+
+// steps every instance of the env as fast as the cpu allows, the way a training framework would drive it.
+int runHeadlessEnv(long long totalTicks)
+{
+    if (loadHeadlessSprites() > 0)
+    {
+        return 1;
+    }
+
+    initializeWorld();
+    initEnv();
+
+    std::cout << "seed: " << gameSeed << ", instances: " << env.instancesCount << ", threads: " << env.pool.workersCount << "\n";
+
+    long long episodesFinished = 0;
+    int bestScore = 0;
+
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    for (long long tick = 0; tick < totalTicks; tick++)
+    {
+        decideEnvActions();
+
+        stepGameEnv(env, envActions.data());
+
+        for (int instance = 0; instance < env.instancesCount; instance++)
+        {
+            if (env.dones[instance])
+            {
+                episodesFinished++;
+                bestScore = std::max(bestScore, env.episodeScores[instance]);
+            }
+        }
+    }
+
+    double elapsedSeconds = (double)(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
+
+    std::cout << "ticks: " << totalTicks << "\n";
+    std::cout << "elapsed seconds: " << elapsedSeconds << "\n";
+    std::cout << "env steps per second: " << (elapsedSeconds > 0 ? totalTicks * env.instancesCount / elapsedSeconds : 0) << "\n";
+    std::cout << "episodes finished: " << episodesFinished << "\n";
+    std::cout << "best score: " << bestScore << std::endl;
+
+    destroyGameEnv(env);
+    quitGame();
+
+    return 0;
+}
+
+// evolves bots on the course of the game seed with the sizes of the real sprites, and saves the best one.
+int runBotTraining(BotTrainerSettings &settings, const char *botFilePath)
+{
+    if (loadHeadlessSprites() > 0)
+    {
+        return 1;
+    }
+
+    initializeWorld();
+
+    settings.courseSeed = gameSeed;
+    settings.tickRate = tickRate;
+
+    BotGenome bestGenome = trainBots(settings, getGameDimensions());
+
+    bool isSaved = saveBotGenome(botFilePath, bestGenome);
+
+    if (isSaved)
+    {
+        std::cout << "bot saved to " << botFilePath << std::endl;
+    }
+
+    quitGame();
+
+    return isSaved ? 0 : 1;
+}
+
+// independent games with consecutive seeds, each one stepped on its own thread.
+int runHeadlessGames(long long ticksPerGame, int gamesCount)
+{
+    if (loadHeadlessSprites() > 0)
+    {
+        return 1;
+    }
+
+    initializeWorld();
+
+    std::cout << "seeds: " << gameSeed << " to " << gameSeed + gamesCount - 1 << "\n";
+
+    std::vector<HeadlessGame> headlessGames(gamesCount);
+    std::vector<SDL_Thread *> threads;
+
+    for (int i = 0; i < gamesCount; i++)
+    {
+        initGameState(headlessGames[i].game, getGameDimensions(), gameSeed + i);
+        headlessGames[i].ticks = ticksPerGame;
+        headlessGames[i].gamesPlayed = 0;
+        headlessGames[i].bestScore = 0;
+    }
+
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    for (HeadlessGame &headlessGame : headlessGames)
+    {
+        SDL_Thread *thread = SDL_CreateThread(runHeadlessGame, "headless game", &headlessGame);
+
+        // without threads the games run one after the other.
+        if (thread == nullptr)
+        {
+            runHeadlessGame(&headlessGame);
+        }
+
+        threads.push_back(thread);
+    }
+
+    long long gamesPlayed = 0;
+    int bestScore = 0;
+
+    for (int i = 0; i < gamesCount; i++)
+    {
+        SDL_WaitThread(threads[i], nullptr);
+
+        gamesPlayed += headlessGames[i].gamesPlayed;
+        bestScore = std::max(bestScore, headlessGames[i].bestScore);
+    }
+
+    double elapsedSeconds = (double)(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
+    long long totalTicks = ticksPerGame * gamesCount;
+
+    std::cout << "headless games: " << gamesCount << ", ticks each: " << ticksPerGame << "\n";
+    std::cout << "elapsed seconds: " << elapsedSeconds << "\n";
+    std::cout << "ticks per second: " << (elapsedSeconds > 0 ? totalTicks / elapsedSeconds : 0) << "\n";
+    std::cout << "games played: " << gamesPlayed << "\n";
+    std::cout << "best score: " << bestScore << std::endl;
+
+    quitGame();
+
+    return 0;
+}
+
+// runs a recording through update() with no user input and no pacing, returns true if it ends like the recorded session.
+bool runReplay(const InputRecording &recording)
+{
+    tickRate = recording.tickRate;
+    initGameState(game, getGameDimensions(), recording.seed);
+
+    const float deltaTime = 1.0f / tickRate;
+    size_t nextInput = 0;
+    std::vector<InputAction> inputs;
+
+    while (game.tick < recording.finalTick)
+    {
+        inputs.clear();
+
+        while (nextInput < recording.inputs.size() && recording.inputs[nextInput].tick == game.tick)
+        {
+            inputs.push_back(recording.inputs[nextInput].action);
+            nextInput++;
+        }
+
+        Uint64 tick = game.tick;
+
+        handleGameStepResult(stepGame(game, inputs.data(), inputs.size(), deltaTime));
+
+        if (game.tick == tick)
         {
-            makeBirdAnimation(framesCounter, currentFrame, birdsBounds);
+            // over or paused with nothing left that could resume the simulation, the replay diverged.
+            break;
+        }
+    }
+
+    while (nextInput < recording.inputs.size() && recording.inputs[nextInput].tick == game.tick)
+    {
+        handleGameStepResult(applyGameInput(game, recording.inputs[nextInput].action));
+        nextInput++;
+    }
+
+    return game.tick == recording.finalTick && game.score == recording.finalScore;
+}
+
+int runReplays(const std::vector<const char *> &replayFilePaths)
+{
+    if (loadHeadlessSprites() > 0)
+    {
+        return 1;
+    }
+
+    initializeWorld();
+
+    // a replay run must not record itself.
+    recordingFilePath = nullptr;
+
+    InputRecording recording;
+    int failedReplays = 0;
+    Uint64 totalTicks = 0;
+
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    for (const char *replayFilePath : replayFilePaths)
+    {
+        if (!loadInputRecording(recording, replayFilePath))
+        {
+            failedReplays++;
+            continue;
+        }
+
+        bool isMatching = runReplay(recording);
+        totalTicks += game.tick;
+
+        if (!isMatching)
+        {
+            failedReplays++;
+            std::cout << replayFilePath << ": diverged, tick " << game.tick << " score " << game.score
+                      << ", recorded tick " << recording.finalTick << " score " << recording.finalScore << "\n";
+        }
+    }
+
+    double elapsedSeconds = (double)(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
+
+    std::cout << "replays: " << replayFilePaths.size() << ", failed: " << failedReplays << "\n";
+    std::cout << "replayed ticks: " << totalTicks << " in " << elapsedSeconds << " seconds" << std::endl;
+
+    quitGame();
+
+    return failedReplays > 0 ? 1 : 0;
+}
+
+int runSimulation(void *data)
+{
+    // everything the simulation touches is global, the thread takes no argument.
+    (void)data;
+
+    const float fixedDeltaTime = 1.0f / tickRate;
+
+    while (SDL_AtomicGet(&isSimulationStopping) == 0)
+    {
+        QueuedEvent event;
+
+        while (popQueuedEvent(gameEvents, event))
+        {
+            handleGameEvent((GameEvent)event.code, event.inputCounter);
+        }
+
+        // paused or over, only an event can change the game, like in the loop of the main thread.
+        if (!isGameWaiting(game))
+        {
+            update(fixedDeltaTime);
+        }
+
+        captureRenderSnapshot(snapshots[getTripleBufferBack(snapshotsBuffer)]);
+        publishTripleBuffer(snapshotsBuffer);
+
+        waitForNextFrame(simulationPacer);
+    }
+
+    return 0;
+}
+
+void startSimulationThread()
+{
+    initEventQueue(gameEvents);
+    initTripleBuffer(snapshotsBuffer);
+    SDL_AtomicSet(&isSimulationStopping, 0);
+
+    // the render thread has a snapshot to draw before the first tick.
+    captureRenderSnapshot(snapshots[getTripleBufferFront(snapshotsBuffer)]);
+
+    initFixedRatePacer(simulationPacer, tickRate);
+
+    simulationThread = SDL_CreateThread(runSimulation, "simulation", nullptr);
+
+    if (simulationThread == nullptr)
+    {
+        printf("Failed to start the simulation thread, running it on the main thread: %s\n", SDL_GetError());
+    }
+}
+
+void stopSimulationThread()
+{
+    if (simulationThread == nullptr)
+    {
+        return;
+    }
+
+    SDL_AtomicSet(&isSimulationStopping, 1);
+    SDL_WaitThread(simulationThread, nullptr);
+    simulationThread = nullptr;
+}
+
+int printLeaderboard(int count)
+{
+    if (!openRunHistory(runHistory, runHistoryFilePath))
+    {
+        return 1;
+    }
+
+    std::cout << "runs: " << runHistory.recordsCount << "\n";
+
+    int rank = 1;
+
+    for (const RunIndexEntry &entry : getTopRuns(runHistory, count))
+    {
+        RunRecord record;
+
+        if (readRunRecord(runHistory, entry.recordIndex, record))
+        {
+            std::cout << rank << ". score: " << record.score << " duration: " << record.durationMilliseconds / 1000.0 << "s seed: " << record.seed
+                      << " timestamp: " << record.timestamp << "\n";
+        }
+
+        rank++;
+    }
+
+    if (runHistory.recordsCount > 0)
+    {
+        int highScore = loadHighScore(highScoreFilePath);
+
+        std::cout << "rank of a score of " << highScore << ": " << getRunRank(runHistory, highScore) << std::endl;
+    }
+
+    closeRunHistory(runHistory);
+
+    return 0;
+}
+
+int main(int argc, char *args[])
+{
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    // the simd kernels are picked before any thread pool or simulation thread starts.
+    initBirdCollisions();
+    initBotBatchKernel();
+
+    long long headlessTicks = 1000000;
+    int headlessGamesCount = 0;
+    bool isTrainingBots = false;
+    BotTrainerSettings botTrainerSettings;
+    initBotTrainerSettings(botTrainerSettings);
+    const char *botFilePath = "bot.txt";
+    std::vector<const char *> replayFilePaths;
+    const char *assetPackFilePath = "assets.pak";
+    const char *textureCacheDirectory = "texture-cache";
+    bool isBenchmarkingTextureCache = false;
+    bool isRunHistoryRequested = false;
+    int leaderboardCount = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = args[i];
+
+        if (argument == "--headless")
+        {
+            isHeadless = true;
+        }
+        else if (argument == "--ticks" && i + 1 < argc)
+        {
+            headlessTicks = std::atoll(args[++i]);
+        }
+        else if (argument == "--headless-games" && i + 1 < argc)
+        {
+            isHeadless = true;
+            headlessGamesCount = std::max(1, std::atoi(args[++i]));
+        }
+        else if (argument == "--tick-rate" && i + 1 < argc)
+        {
+            tickRate = std::max(1, std::atoi(args[++i]));
+        }
+        else if (argument == "--fps" && i + 1 < argc)
+        {
+            frameRate = std::atoi(args[++i]);
+        }
+        else if (argument == "--seed" && i + 1 < argc)
+        {
+            gameSeed = std::strtoull(args[++i], nullptr, 10);
+        }
+        else if (argument == "--record" && i + 1 < argc)
+        {
+            recordingFilePath = args[++i];
+        }
+        else if (argument == "--asset-pack" && i + 1 < argc)
+        {
+            assetPackFilePath = args[++i];
+        }
+        else if (argument == "--pack-assets" && i + 1 < argc)
+        {
+            // offline packing: the pack path followed by every file to put in it.
+            const char *packFilePath = args[++i];
+            std::vector<const char *> filePaths(args + i + 1, args + argc);
+
+            return writeAssetPack(packFilePath, filePaths) ? 0 : 1;
+        }
+        else if (argument == "--no-texture-cache")
+        {
+            textureCacheDirectory = "";
+        }
+        else if (argument == "--benchmark-texture-cache")
+        {
+            isBenchmarkingTextureCache = true;
+        }
+        else if (argument == "--run-history" && i + 1 < argc)
+        {
+            runHistoryFilePath = args[++i];
+            isRunHistoryRequested = true;
+        }
+        else if (argument == "--leaderboard" && i + 1 < argc)
+        {
+            leaderboardCount = std::max(1, std::atoi(args[++i]));
+        }
+        else if (argument == "--audio-engine")
+        {
+            audioEngineBufferFrames = 256;
+
+            if (i + 1 < argc && args[i + 1][0] != '-')
+            {
+                audioEngineBufferFrames = std::max(16, std::atoi(args[++i]));
+            }
+        }
+        else if (argument == "--audio-latency")
+        {
+            audioEngine.isMeasuringLatency = true;
+        }
+        else if (argument == "--simulation-thread")
+        {
+            isSimulationThreaded = true;
+        }
+        else if (argument == "--train-bots" && i + 1 < argc)
+        {
+            isHeadless = true;
+            isTrainingBots = true;
+            botTrainerSettings.generationsCount = std::max(1, std::atoi(args[++i]));
+        }
+        else if (argument == "--population" && i + 1 < argc)
+        {
+            botTrainerSettings.populationSize = std::max(2, std::atoi(args[++i]));
+        }
+        else if (argument == "--workers" && i + 1 < argc)
+        {
+            botTrainerSettings.workersCount = std::atoi(args[++i]);
+        }
+        else if (argument == "--bot" && i + 1 < argc)
+        {
+            botFilePath = args[++i];
+            isBotPlaying = true;
+        }
+        else if (argument == "--flock" && i + 1 < argc)
+        {
+            isFlockMode = true;
+            flockBirdsCount = std::max(1, std::atoi(args[++i]));
+        }
+        else if (argument == "--env" && i + 1 < argc)
+        {
+            isEnvMode = true;
+            envInstancesCount = std::max(1, std::atoi(args[++i]));
+        }
+        else if (argument == "--check-collision-kernels")
+        {
+            return checkBirdCollisionKernels() ? 0 : 1;
+        }
+        else if (argument == "--benchmark-inference")
+        {
+            int botsCount = i + 1 < argc && args[i + 1][0] != '-' ? std::max(1, std::atoi(args[++i])) : 16384;
+            benchmarkBotBatch(botsCount);
+            return 0;
+        }
+        else if (argument == "--replay")
+        {
+            // every following argument that isn't a flag is a replay file.
+            while (i + 1 < argc && args[i + 1][0] != '-')
+            {
+                replayFilePaths.push_back(args[++i]);
+            }
+        }
+    }
+
+    // without a pack every asset is read from the res folder.
+    if (mountAssetPack(assetPackFilePath))
+    {
+        std::cout << "asset pack: " << assetPackFilePath << "\n";
+    }
+
+    initTextureCache(textureCacheDirectory);
+
+    if (isBenchmarkingTextureCache)
+    {
+        IMG_Init(IMG_INIT_PNG);
+
+        std::vector<const char *> imageFilePaths;
+
+        for (AtlasEntry &atlasEntry : makeAtlasEntries())
+        {
+            imageFilePaths.push_back(atlasEntry.filePath);
+        }
+
+        benchmarkTextureCache(imageFilePaths.data(), imageFilePaths.size(), 20);
+
+        IMG_Quit();
+        return 0;
+    }
+
+    if (leaderboardCount > 0)
+    {
+        return printLeaderboard(leaderboardCount);
+    }
+
+    if (!replayFilePaths.empty())
+    {
+        isHeadless = true;
+        return runReplays(replayFilePaths);
+    }
+
+    // the trainer never records runs.
+    if (isTrainingBots)
+    {
+        return runBotTraining(botTrainerSettings, botFilePath);
+    }
+
+    if (!isHeadless || isRunHistoryRequested)
+    {
+        openRunHistory(runHistory, runHistoryFilePath);
+    }
+
+    if (isBotPlaying && !loadBotGenome(botFilePath, botGenome))
+    {
+        return 1;
+    }
+
+    if (isFlockMode && isHeadless)
+    {
+        return runHeadlessFlock(headlessTicks);
+    }
+
+    // the env spreads its instances over as many threads as the trainer.
+    envWorkersCount = botTrainerSettings.workersCount;
+
+    if (isEnvMode && isHeadless)
+    {
+        return runHeadlessEnv(headlessTicks);
+    }
+
+    if (headlessGamesCount > 0)
+    {
+        return runHeadlessGames(headlessTicks, headlessGamesCount);
+    }
+
+    if (isHeadless)
+    {
+        return runHeadless(headlessTicks);
+    }
+
+    window = SDL_CreateWindow("My Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+
+    if (startSDL(window, renderer, audioEngineBufferFrames == 0) > 0)
+    {
+        return 1;
+    }
+
+    if (audioEngineBufferFrames > 0)
+    {
+        openAudioEngine(audioEngine, audioEngineBufferFrames, 8);
+    }
+
+    fontSquare = TTF_OpenFontRW(openAsset("res/fonts/square_sans_serif_7.ttf"), 1, 36);
+    profilerFont = TTF_OpenFontRW(openAsset("res/fonts/PressStart2P.ttf"), 1, 10);
+
+    buildGlyphAtlas(renderer, fontSquare, hudGlyphs);
+    buildGlyphAtlas(renderer, profilerFont, profilerGlyphs);
+
+    startHighScoreWriter(highScoreWriter, highScoreFilePath);
+
+    loadAssets(startCounter);
+
+    initializeWorld();
+    game.highScore = loadHighScore(highScoreFilePath);
+
+    if (isFlockMode)
+    {
+        initFlock();
+    }
+
+    if (isEnvMode)
+    {
+        initEnv();
+    }
+
+    birdsBounds = {birdSprites.sourceBounds.x, birdSprites.sourceBounds.y, birdSprites.textureBounds.w / 3, birdSprites.textureBounds.h};
+
+    float animationTimer = 0;
+    int currentFrame = 0;
+
+    const Uint64 counterFrequency = SDL_GetPerformanceFrequency();
+
+    Uint64 previousFrameTime = SDL_GetPerformanceCounter();
+    Uint64 currentFrameTime = previousFrameTime;
+    float deltaTime = 0.0f;
+
+    const float fixedDeltaTime = 1.0f / tickRate;
+    float accumulator = 0;
+
+    std::cout << "seed: " << gameSeed << std::endl;
+
+    initFramePacer(framePacer, window, renderer, frameRate);
+    initFrameProfiler(frameProfiler);
+    initSpriteBatch(spriteBatch, renderer, 64);
+    initRenderLayers();
+
+    if (isSimulationThreaded)
+    {
+        startSimulationThread();
+    }
+
+    const Uint64 tickDuration = counterFrequency / tickRate;
+
+    while (true)
+    {
+        currentFrameTime = SDL_GetPerformanceCounter();
+        deltaTime = (float)(currentFrameTime - previousFrameTime) / counterFrequency;
+        previousFrameTime = currentFrameTime;
 
-            update(deltaTime);
+        // after a long stall, drop the lost time instead of running a burst of ticks to catch up.
+        if (deltaTime > 0.25f)
+        {
+            deltaTime = 0.25f;
+        }
+
+        beginProfilerFrame(frameProfiler);
+
+        handleEvents();
+
+        markProfilerPhase(frameProfiler, PHASE_EVENTS);
+
+        RenderSnapshot *snapshot = &snapshots[0];
+        float alpha;
+
+        if (simulationThread != nullptr)
+        {
+            takeTripleBufferFront(snapshotsBuffer);
+            snapshot = &snapshots[getTripleBufferFront(snapshotsBuffer)];
+
+            // how far the present is past the latest tick, the simulation thread keeps its own time.
+            alpha = SDL_min(1.0f, (float)(SDL_GetPerformanceCounter() - snapshot->tickCounter) / tickDuration);
+
+            if (!snapshot->isGameOver && !snapshot->isGamePaused)
+            {
+                makeBirdAnimation(deltaTime, animationTimer, currentFrame, birdsBounds);
+            }
+        }
+        else
+        {
+            if (!isGameWaiting(game))
+            {
+                accumulator += deltaTime;
+
+                while (accumulator >= fixedDeltaTime && !game.isGameOver)
+                {
+                    makeBirdAnimation(fixedDeltaTime, animationTimer, currentFrame, birdsBounds);
+
+                    update(fixedDeltaTime);
+
+                    accumulator -= fixedDeltaTime;
+                }
+            }
+
+            captureRenderSnapshot(*snapshot);
+            alpha = accumulator / fixedDeltaTime;
+        }
+
+        markProfilerPhase(frameProfiler, PHASE_UPDATE);
+
+        render(*snapshot, alpha);
+
+        if (isProfilerOverlayVisible)
+        {
+            renderProfilerOverlay(deltaTime);
         }
 
-        render(deltaTime);
+        markProfilerPhase(frameProfiler, PHASE_RENDER);
+
+        SDL_RenderPresent(renderer);
+
+        markProfilerPhase(frameProfiler, PHASE_PRESENT);
+
+        waitForNextFrame(framePacer);
+
+        markProfilerPhase(frameProfiler, PHASE_PACING);
 
-        capFrameRate(currentFrameTime);
+        endProfilerFrame(frameProfiler);
     }
 }
\ No newline at end of file
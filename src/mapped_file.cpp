@@ -0,0 +1,104 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool mapFile(MappedFile &mappedFile, const char *filePath)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = NULL;
+    const void *data = NULL;
+
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+    {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+
+    if (mapping != NULL)
+    {
+        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+
+    if (data == NULL)
+    {
+        if (mapping != NULL)
+        {
+            CloseHandle(mapping);
+        }
+
+        CloseHandle(file);
+        return false;
+    }
+
+    mappedFile.data = (const Uint8 *)data;
+    mappedFile.size = fileSize.QuadPart;
+    mappedFile.file = file;
+    mappedFile.mapping = mapping;
+#else
+    int file = open(filePath, O_RDONLY);
+
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStatus;
+
+    if (fstat(file, &fileStatus) != 0 || fileStatus.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    void *data = mmap(NULL, fileStatus.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    // the mapping stays valid after closing the descriptor.
+    close(file);
+
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mappedFile.data = (const Uint8 *)data;
+    mappedFile.size = fileStatus.st_size;
+    mappedFile.file = nullptr;
+    mappedFile.mapping = nullptr;
+#endif
+
+    return true;
+}
+
+void unmapFile(MappedFile &mappedFile)
+{
+    if (mappedFile.data == nullptr)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mappedFile.data);
+    CloseHandle((HANDLE)mappedFile.mapping);
+    CloseHandle((HANDLE)mappedFile.file);
+#else
+    munmap((void *)mappedFile.data, mappedFile.size);
+#endif
+
+    mappedFile = MappedFile{};
+}
@@ -0,0 +1,42 @@
+#include "pipe_course.h"
+
+void initPipeCourse(PipeCourse &course, Uint64 seed, float lowestGapCenter, int gapCenterRange, float gapHeight)
+{
+    course.seed = seed;
+    course.lowestGapCenter = lowestGapCenter;
+    course.gapCenterRange = gapCenterRange;
+    course.gapHeight = gapHeight;
+
+    restartPipeCourse(course);
+}
+
+void restartPipeCourse(PipeCourse &course)
+{
+    seedRandomGenerator(course.random, course.seed);
+
+    course.nextLayout = 0;
+    course.layoutsCount = 0;
+}
+
+void generatePipeLayouts(PipeCourse &course)
+{
+    for (int i = 0; i < PIPE_COURSE_LOOKAHEAD; i++)
+    {
+        float gapCenter = course.lowestGapCenter - nextRandomBounded(course.random, course.gapCenterRange);
+
+        course.layouts[i] = {gapCenter, course.gapHeight};
+    }
+
+    course.nextLayout = 0;
+    course.layoutsCount = PIPE_COURSE_LOOKAHEAD;
+}
+
+PipeLayout nextPipeLayout(PipeCourse &course)
+{
+    if (course.nextLayout == course.layoutsCount)
+    {
+        generatePipeLayouts(course);
+    }
+
+    return course.layouts[course.nextLayout++];
+}
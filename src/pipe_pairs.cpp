@@ -0,0 +1,166 @@
+#include "pipe_pairs.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PIPE_PAIRS_SSE2
+#endif
+
+void pushPipePair(PipePairs &pairs, float x, float gapCenter, float gapHeight)
+{
+    // when full the oldest pair is dropped, it is long off screen by then.
+    if (pairs.count == PIPE_PAIRS_CAPACITY)
+    {
+        popPipePair(pairs);
+    }
+
+    int index = getPipePairIndex(pairs, pairs.count);
+
+    pairs.x[index] = x;
+    pairs.previousX[index] = x;
+    pairs.gapCenter[index] = gapCenter;
+    pairs.gapHeight[index] = gapHeight;
+    pairs.isBehind[index] = 0;
+
+    pairs.count++;
+}
+
+void popPipePair(PipePairs &pairs)
+{
+    pairs.first = (pairs.first + 1) & (PIPE_PAIRS_CAPACITY - 1);
+    pairs.count--;
+}
+
+void clearPipePairs(PipePairs &pairs)
+{
+    pairs.first = 0;
+    pairs.count = 0;
+}
+
+void savePipePairsPositions(PipePairs &pairs)
+{
+    // the live pairs wrap around the end of the arrays at most once.
+    int firstSegmentCount = SDL_min(pairs.count, PIPE_PAIRS_CAPACITY - pairs.first);
+
+    memcpy(pairs.previousX + pairs.first, pairs.x + pairs.first, firstSegmentCount * sizeof(float));
+    memcpy(pairs.previousX, pairs.x, (pairs.count - firstSegmentCount) * sizeof(float));
+}
+
+// moves and tests the pairs [begin, end), which don't wrap around.
+void movePipePairsSegment(PipePairs &pairs, int begin, int end, float distance, const SDL_FRect &bird, float pipeWidth, PipePairsStep &step)
+{
+    float birdLeft = bird.x;
+    float birdRight = bird.x + bird.w;
+    float birdTop = bird.y;
+    float birdBottom = bird.y + bird.h;
+
+    int i = begin;
+
+#ifdef PIPE_PAIRS_SSE2
+    __m128 distances = _mm_set1_ps(distance);
+    __m128 pipeWidths = _mm_set1_ps(pipeWidth);
+    __m128 halves = _mm_set1_ps(0.5f);
+    __m128 birdLefts = _mm_set1_ps(birdLeft);
+    __m128 birdRights = _mm_set1_ps(birdRight);
+    __m128 birdTops = _mm_set1_ps(birdTop);
+    __m128 birdBottoms = _mm_set1_ps(birdBottom);
+
+    __m128 collisions = _mm_setzero_ps();
+
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 x = _mm_sub_ps(_mm_loadu_ps(pairs.x + i), distances);
+        _mm_storeu_ps(pairs.x + i, x);
+
+        __m128 halfGaps = _mm_mul_ps(_mm_loadu_ps(pairs.gapHeight + i), halves);
+        __m128 gapCenters = _mm_loadu_ps(pairs.gapCenter + i);
+        __m128 gapTops = _mm_sub_ps(gapCenters, halfGaps);
+        __m128 gapBottoms = _mm_add_ps(gapCenters, halfGaps);
+
+        __m128 isOverlappingX = _mm_and_ps(_mm_cmplt_ps(birdLefts, _mm_add_ps(x, pipeWidths)), _mm_cmpgt_ps(birdRights, x));
+        __m128 isOutsideGap = _mm_or_ps(_mm_cmplt_ps(birdTops, gapTops), _mm_cmpgt_ps(birdBottoms, gapBottoms));
+
+        collisions = _mm_or_ps(collisions, _mm_and_ps(isOverlappingX, isOutsideGap));
+
+        __m128i isBehind = _mm_loadu_si128((const __m128i *)(pairs.isBehind + i));
+        __m128i isNowBehind = _mm_castps_si128(_mm_cmpgt_ps(birdLefts, x));
+        __m128i justPassed = _mm_andnot_si128(isBehind, isNowBehind);
+
+        _mm_storeu_si128((__m128i *)(pairs.isBehind + i), _mm_or_si128(isBehind, isNowBehind));
+
+        int passedMask = _mm_movemask_ps(_mm_castsi128_ps(justPassed));
+        step.passedPairs += (passedMask & 1) + ((passedMask >> 1) & 1) + ((passedMask >> 2) & 1) + ((passedMask >> 3) & 1);
+    }
+
+    if (_mm_movemask_ps(collisions) != 0)
+    {
+        step.isBirdColliding = true;
+    }
+#endif
+
+    for (; i < end; i++)
+    {
+        float x = pairs.x[i] - distance;
+        pairs.x[i] = x;
+
+        float halfGap = pairs.gapHeight[i] * 0.5f;
+        float gapTop = pairs.gapCenter[i] - halfGap;
+        float gapBottom = pairs.gapCenter[i] + halfGap;
+
+        bool isOverlappingX = birdLeft < x + pipeWidth && birdRight > x;
+        bool isOutsideGap = birdTop < gapTop || birdBottom > gapBottom;
+
+        step.isBirdColliding |= isOverlappingX && isOutsideGap;
+
+        if (!pairs.isBehind[i] && birdLeft > x)
+        {
+            pairs.isBehind[i] = -1;
+            step.passedPairs++;
+        }
+    }
+}
+
+PipePairsStep movePipePairs(PipePairs &pairs, float distance, const SDL_FRect &bird, float pipeWidth)
+{
+    PipePairsStep step = {false, 0};
+
+    int firstSegmentCount = SDL_min(pairs.count, PIPE_PAIRS_CAPACITY - pairs.first);
+
+    movePipePairsSegment(pairs, pairs.first, pairs.first + firstSegmentCount, distance, bird, pipeWidth, step);
+    movePipePairsSegment(pairs, 0, pairs.count - firstSegmentCount, distance, bird, pipeWidth, step);
+
+    return step;
+}
+
+bool findPipeOpening(const PipePairs &pairs, float left, float right, float pipeWidth, float &openingTop, float &openingBottom)
+{
+    bool isOverlapping = false;
+
+    for (int i = 0; i < pairs.count; i++)
+    {
+        int index = getPipePairIndex(pairs, i);
+        float x = pairs.x[index];
+
+        if (left < x + pipeWidth && right > x)
+        {
+            float halfGap = pairs.gapHeight[index] * 0.5f;
+            float gapTop = pairs.gapCenter[index] - halfGap;
+            float gapBottom = pairs.gapCenter[index] + halfGap;
+
+            openingTop = isOverlapping ? SDL_max(openingTop, gapTop) : gapTop;
+            openingBottom = isOverlapping ? SDL_min(openingBottom, gapBottom) : gapBottom;
+            isOverlapping = true;
+        }
+    }
+
+    return isOverlapping;
+}
+
+void removePassedPipePairs(PipePairs &pairs, float pipeWidth)
+{
+    // every pair moves at the same speed, so the ones leaving the screen are always at the front.
+    while (pairs.count > 0 && pairs.x[pairs.first] < -pipeWidth)
+    {
+        popPipePair(pairs);
+    }
+}
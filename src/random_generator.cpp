@@ -0,0 +1,81 @@
+#include "random_generator.h"
+#include <ctime>
+
+Uint64 nextSplitMix64(Uint64 &state)
+{
+    state += 0x9E3779B97F4A7C15ull;
+
+    Uint64 result = state;
+    result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ull;
+    result = (result ^ (result >> 27)) * 0x94D049BB133111EBull;
+
+    return result ^ (result >> 31);
+}
+
+void seedRandomGenerator(RandomGenerator &random, Uint64 seed)
+{
+    // splitmix64 never produces an all zero state, which xoshiro can't leave.
+    Uint64 first = nextSplitMix64(seed);
+    Uint64 second = nextSplitMix64(seed);
+
+    random.state[0] = (Uint32)first;
+    random.state[1] = (Uint32)(first >> 32);
+    random.state[2] = (Uint32)second;
+    random.state[3] = (Uint32)(second >> 32);
+}
+
+Uint32 rotateLeft(Uint32 value, int shift)
+{
+    return (value << shift) | (value >> (32 - shift));
+}
+
+Uint32 nextRandom(RandomGenerator &random)
+{
+    Uint32 *state = random.state;
+
+    Uint32 result = rotateLeft(state[1] * 5, 7) * 9;
+    Uint32 shifted = state[1] << 9;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+
+    state[2] ^= shifted;
+    state[3] = rotateLeft(state[3], 11);
+
+    return result;
+}
+
+Uint32 nextRandomBounded(RandomGenerator &random, Uint32 bound)
+{
+    // Lemire's multiply and reject method.
+    Uint64 product = (Uint64)nextRandom(random) * bound;
+    Uint32 low = (Uint32)product;
+
+    if (low < bound)
+    {
+        Uint32 threshold = -bound % bound;
+
+        while (low < threshold)
+        {
+            product = (Uint64)nextRandom(random) * bound;
+            low = (Uint32)product;
+        }
+    }
+
+    return (Uint32)(product >> 32);
+}
+
+float nextRandomFloat(RandomGenerator &random)
+{
+    // the top 24 bits fit exactly in a float mantissa.
+    return (nextRandom(random) >> 8) * (1.0f / 16777216.0f);
+}
+
+Uint64 makeRandomSeed()
+{
+    Uint64 state = SDL_GetPerformanceCounter() ^ ((Uint64)time(NULL) << 32);
+
+    return nextSplitMix64(state);
+}
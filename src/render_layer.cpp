@@ -0,0 +1,81 @@
+#include "render_layer.h"
+
+bool initRenderLayer(SDL_Renderer *renderer, RenderLayer &layer, SDL_Rect bounds, bool isTransparent)
+{
+    layer = RenderLayer{};
+    layer.bounds = bounds;
+
+    if (!SDL_RenderTargetSupported(renderer) || bounds.w <= 0 || bounds.h <= 0)
+    {
+        return false;
+    }
+
+    layer.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, bounds.w, bounds.h);
+
+    if (layer.texture == nullptr)
+    {
+        printf("Failed to create render layer: %s\n", SDL_GetError());
+        return false;
+    }
+
+    // an opaque layer is a plain copy, no blending needed when it's drawn. a transparent one is
+    // composed by blending into a clear target, so its colors are already multiplied by their alpha
+    // and it's drawn premultiplied, blending it again would darken the antialiased edges.
+    SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+
+    if (isTransparent)
+    {
+        blendMode = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                               SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    }
+
+    if (SDL_SetTextureBlendMode(layer.texture, blendMode) != 0)
+    {
+        printf("Failed to set render layer blend mode: %s\n", SDL_GetError());
+
+        destroyRenderLayer(layer);
+        return false;
+    }
+
+    layer.isDirty = true;
+
+    return true;
+}
+
+void destroyRenderLayer(RenderLayer &layer)
+{
+    SDL_DestroyTexture(layer.texture);
+    layer.texture = nullptr;
+}
+
+void markRenderLayerDirty(RenderLayer &layer)
+{
+    layer.isDirty = true;
+}
+
+void beginRenderLayer(SpriteBatch &batch, RenderLayer &layer)
+{
+    flushSpriteBatch(batch);
+
+    SDL_SetRenderTarget(batch.renderer, layer.texture);
+
+    SDL_SetRenderDrawColor(batch.renderer, 0, 0, 0, 0);
+    SDL_RenderClear(batch.renderer);
+}
+
+void endRenderLayer(SpriteBatch &batch, RenderLayer &layer)
+{
+    flushSpriteBatch(batch);
+
+    SDL_SetRenderTarget(batch.renderer, NULL);
+
+    layer.isDirty = false;
+}
+
+void drawRenderLayer(SpriteBatch &batch, const RenderLayer &layer)
+{
+    SDL_Rect source = {0, 0, layer.bounds.w, layer.bounds.h};
+    SDL_FRect destination = {(float)layer.bounds.x, (float)layer.bounds.y, (float)layer.bounds.w, (float)layer.bounds.h};
+
+    drawTexturedQuad(batch, layer.texture, source, destination, 0);
+}
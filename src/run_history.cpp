@@ -0,0 +1,402 @@
+#include "run_history.h"
+#include "high_score_writer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+// the log file holds the descriptor plus one, so that 0 stays free to mean closed.
+int getLogDescriptor(intptr_t file)
+{
+    return (int)file - 1;
+}
+#endif
+
+intptr_t openLogFile(const char *filePath)
+{
+#ifdef _WIN32
+    // shared for writing, other processes append to the same log.
+    HANDLE file = CreateFileA(filePath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+
+    return file == INVALID_HANDLE_VALUE ? 0 : (intptr_t)file;
+#else
+    int file = open(filePath, O_RDWR | O_CREAT, 0644);
+
+    return file < 0 ? 0 : file + 1;
+#endif
+}
+
+void closeLogFile(intptr_t file)
+{
+#ifdef _WIN32
+    CloseHandle((HANDLE)file);
+#else
+    close(getLogDescriptor(file));
+#endif
+}
+
+// the lock is only taken by the processes sharing the log, it doesn't stop anyone from reading it.
+void lockLogFile(intptr_t file)
+{
+#ifdef _WIN32
+    // windows locks are mandatory, so a byte far past any record is locked instead of the records themselves.
+    OVERLAPPED lockPosition = {};
+    lockPosition.OffsetHigh = 0x7FFFFFFF;
+    LockFileEx((HANDLE)file, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &lockPosition);
+#else
+    flock(getLogDescriptor(file), LOCK_EX);
+#endif
+}
+
+void unlockLogFile(intptr_t file)
+{
+#ifdef _WIN32
+    OVERLAPPED lockPosition = {};
+    lockPosition.OffsetHigh = 0x7FFFFFFF;
+    UnlockFileEx((HANDLE)file, 0, 1, 0, &lockPosition);
+#else
+    flock(getLogDescriptor(file), LOCK_UN);
+#endif
+}
+
+// a run that was only partly written before a crash doesn't count, the next append overwrites it.
+Uint64 countLogRecords(intptr_t file)
+{
+#ifdef _WIN32
+    LARGE_INTEGER fileSize;
+
+    return GetFileSizeEx((HANDLE)file, &fileSize) ? fileSize.QuadPart / sizeof(RunRecord) : 0;
+#else
+    struct stat fileStatus;
+
+    return fstat(getLogDescriptor(file), &fileStatus) == 0 ? fileStatus.st_size / sizeof(RunRecord) : 0;
+#endif
+}
+
+// reads or writes whole records at a record index, without a shared file position.
+bool readLogRecords(intptr_t file, Uint64 recordIndex, RunRecord *records, size_t count)
+{
+    Uint64 offset = recordIndex * sizeof(RunRecord);
+    size_t size = count * sizeof(RunRecord);
+
+#ifdef _WIN32
+    OVERLAPPED position = {};
+    position.Offset = (DWORD)offset;
+    position.OffsetHigh = (DWORD)(offset >> 32);
+    DWORD bytesRead = 0;
+
+    return ReadFile((HANDLE)file, records, (DWORD)size, &bytesRead, &position) && bytesRead == size;
+#else
+    return pread(getLogDescriptor(file), records, size, offset) == (ssize_t)size;
+#endif
+}
+
+bool writeLogRecord(intptr_t file, Uint64 recordIndex, const RunRecord &record)
+{
+    Uint64 offset = recordIndex * sizeof(RunRecord);
+
+#ifdef _WIN32
+    OVERLAPPED position = {};
+    position.Offset = (DWORD)offset;
+    position.OffsetHigh = (DWORD)(offset >> 32);
+    DWORD bytesWritten = 0;
+
+    return WriteFile((HANDLE)file, &record, sizeof(record), &bytesWritten, &position) && bytesWritten == sizeof(record);
+#else
+    return pwrite(getLogDescriptor(file), &record, sizeof(record), offset) == (ssize_t)sizeof(record);
+#endif
+}
+
+// the same conversion reads and writes, it does nothing on little endian machines.
+RunRecord swapRunRecord(const RunRecord &record)
+{
+    RunRecord swapped;
+    swapped.timestamp = (Sint64)SDL_SwapLE64((Uint64)record.timestamp);
+    swapped.seed = SDL_SwapLE64(record.seed);
+    swapped.score = (Sint32)SDL_SwapLE32((Uint32)record.score);
+    swapped.durationMilliseconds = SDL_SwapLE32(record.durationMilliseconds);
+
+    return swapped;
+}
+
+RunIndexEntry swapRunIndexEntry(const RunIndexEntry &entry)
+{
+    return {(Sint32)SDL_SwapLE32((Uint32)entry.score), 0, SDL_SwapLE64(entry.recordIndex)};
+}
+
+bool isRankedBefore(const RunIndexEntry &entry, const RunIndexEntry &otherEntry)
+{
+    if (entry.score != otherEntry.score)
+    {
+        return entry.score > otherEntry.score;
+    }
+
+    return entry.recordIndex < otherEntry.recordIndex;
+}
+
+void unmapRunHistoryIndex(RunHistory &history)
+{
+    unmapFile(history.index);
+    history.indexEntries = nullptr;
+    history.indexEntriesCount = 0;
+}
+
+bool mapRunHistoryIndex(RunHistory &history)
+{
+    if (!mapFile(history.index, history.indexFilePath.c_str()))
+    {
+        return false;
+    }
+
+    const RunIndexHeader *header = (const RunIndexHeader *)history.index.data;
+
+    bool isValid = history.index.size >= sizeof(RunIndexHeader) &&
+                   memcmp(header->magic, RUN_HISTORY_INDEX_MAGIC, sizeof(header->magic)) == 0 &&
+                   SDL_SwapLE32(header->version) == RUN_HISTORY_INDEX_VERSION;
+
+    Uint64 indexedRecords = isValid ? SDL_SwapLE64(header->recordsCount) : 0;
+
+    // one entry per indexed record, and never more records than the log has.
+    isValid = isValid && indexedRecords <= history.recordsCount &&
+              history.index.size == sizeof(RunIndexHeader) + indexedRecords * sizeof(RunIndexEntry);
+
+    if (!isValid)
+    {
+        printf("%s is not a valid run history index, rebuilding it from the log\n", history.indexFilePath.c_str());
+        unmapRunHistoryIndex(history);
+        return false;
+    }
+
+    history.indexEntries = (const RunIndexEntry *)(history.index.data + sizeof(RunIndexHeader));
+    history.indexEntriesCount = indexedRecords;
+
+    return true;
+}
+
+// the entries of the log records [firstRecord, history.recordsCount), in log order.
+bool readLogEntries(RunHistory &history, Uint64 firstRecord, std::vector<RunIndexEntry> &entries)
+{
+    RunRecord records[256];
+
+    for (Uint64 recordIndex = firstRecord; recordIndex < history.recordsCount;)
+    {
+        size_t count = (size_t)SDL_min((Uint64)SDL_arraysize(records), history.recordsCount - recordIndex);
+
+        if (!readLogRecords(history.logFile, recordIndex, records, count))
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < count; i++, recordIndex++)
+        {
+            entries.push_back({swapRunRecord(records[i]).score, 0, recordIndex});
+        }
+    }
+
+    return true;
+}
+
+bool isTailFull(const RunHistory &history)
+{
+    return history.recordsCount - history.indexEntriesCount >= RUN_HISTORY_TAIL_LIMIT;
+}
+
+bool openRunHistory(RunHistory &history, const char *logFilePath)
+{
+    history = RunHistory{};
+    history.logFile = openLogFile(logFilePath);
+    history.logFilePath = logFilePath;
+    history.indexFilePath = history.logFilePath + ".idx";
+
+    if (history.logFile == 0)
+    {
+        printf("Failed to open the run history %s!\n", logFilePath);
+        return false;
+    }
+
+    lockLogFile(history.logFile);
+    history.recordsCount = countLogRecords(history.logFile);
+
+    mapRunHistoryIndex(history);
+    readLogEntries(history, history.indexEntriesCount, history.tail);
+
+    unlockLogFile(history.logFile);
+
+    if (isTailFull(history))
+    {
+        mergeRunHistoryIndex(history);
+    }
+
+    return true;
+}
+
+void closeRunHistory(RunHistory &history)
+{
+    if (history.logFile == 0)
+    {
+        return;
+    }
+
+    unmapRunHistoryIndex(history);
+    closeLogFile(history.logFile);
+
+    history = RunHistory{};
+}
+
+void addRun(RunHistory &history, const RunRecord &record)
+{
+    if (history.logFile == 0)
+    {
+        return;
+    }
+
+    // another process may have appended since, the record goes after whatever the log holds now.
+    lockLogFile(history.logFile);
+
+    Uint64 recordIndex = countLogRecords(history.logFile);
+    bool isWritten = writeLogRecord(history.logFile, recordIndex, swapRunRecord(record));
+
+    unlockLogFile(history.logFile);
+
+    if (!isWritten)
+    {
+        printf("Failed to add a run to %s!\n", history.logFilePath.c_str());
+        return;
+    }
+
+    history.recordsCount = recordIndex + 1;
+    history.tail.push_back({record.score, 0, recordIndex});
+
+    if (isTailFull(history))
+    {
+        mergeRunHistoryIndex(history);
+    }
+}
+
+bool writeMergedIndex(RunHistory &history)
+{
+    // the tail only knows the runs of this process, the log has the ones of every process.
+    std::vector<RunIndexEntry> newEntries;
+    history.recordsCount = countLogRecords(history.logFile);
+
+    if (!readLogEntries(history, history.indexEntriesCount, newEntries))
+    {
+        return false;
+    }
+
+    std::sort(newEntries.begin(), newEntries.end(), isRankedBefore);
+
+    Uint64 entriesCount = history.indexEntriesCount + newEntries.size();
+
+    std::vector<Uint8> indexData(sizeof(RunIndexHeader) + entriesCount * sizeof(RunIndexEntry));
+
+    RunIndexHeader header;
+    memcpy(header.magic, RUN_HISTORY_INDEX_MAGIC, sizeof(header.magic));
+    header.version = SDL_SwapLE32(RUN_HISTORY_INDEX_VERSION);
+    header.recordsCount = SDL_SwapLE64(entriesCount);
+
+    memcpy(indexData.data(), &header, sizeof(header));
+
+    RunIndexEntry *mergedEntries = (RunIndexEntry *)(indexData.data() + sizeof(RunIndexHeader));
+    const RunIndexEntry *indexEntry = history.indexEntries;
+    const RunIndexEntry *indexEnd = history.indexEntries + history.indexEntriesCount;
+    size_t newIndex = 0;
+
+    for (Uint64 i = 0; i < entriesCount; i++)
+    {
+        bool isFromIndex = newIndex == newEntries.size() ||
+                           (indexEntry != indexEnd && !isRankedBefore(newEntries[newIndex], swapRunIndexEntry(*indexEntry)));
+
+        mergedEntries[i] = isFromIndex ? *indexEntry++ : swapRunIndexEntry(newEntries[newIndex++]);
+    }
+
+    // windows can't replace a file that is still mapped.
+    unmapRunHistoryIndex(history);
+
+    if (!writeFileAtomically(history.indexFilePath.c_str(), indexData.data(), indexData.size()) || !mapRunHistoryIndex(history))
+    {
+        // every run stays in memory so the queries stay right, the next merge tries again.
+        history.tail.resize(entriesCount);
+
+        for (Uint64 i = 0; i < entriesCount; i++)
+        {
+            history.tail[i] = swapRunIndexEntry(mergedEntries[i]);
+        }
+
+        return false;
+    }
+
+    history.tail.clear();
+
+    return true;
+}
+
+bool mergeRunHistoryIndex(RunHistory &history)
+{
+    // one process merges at a time, they all write the index through the same temporary file.
+    lockLogFile(history.logFile);
+    bool isMerged = writeMergedIndex(history);
+    unlockLogFile(history.logFile);
+
+    return isMerged;
+}
+
+// the tail holds at most RUN_HISTORY_TAIL_LIMIT runs, it's scanned instead of kept sorted.
+Uint64 getRunRank(const RunHistory &history, int score)
+{
+    const RunIndexEntry *indexEnd = history.indexEntries + history.indexEntriesCount;
+
+    const RunIndexEntry *firstNotBetterIndexEntry = std::partition_point(history.indexEntries, indexEnd, [score](const RunIndexEntry &entry)
+                                                                         { return (Sint32)SDL_SwapLE32((Uint32)entry.score) > score; });
+
+    Uint64 betterTailRuns = std::count_if(history.tail.begin(), history.tail.end(), [score](const RunIndexEntry &entry)
+                                          { return entry.score > score; });
+
+    return (firstNotBetterIndexEntry - history.indexEntries) + betterTailRuns + 1;
+}
+
+std::vector<RunIndexEntry> getTopRuns(const RunHistory &history, size_t count)
+{
+    std::vector<RunIndexEntry> topTailRuns(SDL_min(count, history.tail.size()));
+    std::partial_sort_copy(history.tail.begin(), history.tail.end(), topTailRuns.begin(), topTailRuns.end(), isRankedBefore);
+
+    std::vector<RunIndexEntry> topRuns;
+
+    Uint64 indexPosition = 0;
+    size_t tailPosition = 0;
+
+    while (topRuns.size() < count && (indexPosition < history.indexEntriesCount || tailPosition < topTailRuns.size()))
+    {
+        bool isFromIndex = tailPosition == topTailRuns.size() ||
+                           (indexPosition < history.indexEntriesCount &&
+                            !isRankedBefore(topTailRuns[tailPosition], swapRunIndexEntry(history.indexEntries[indexPosition])));
+
+        topRuns.push_back(isFromIndex ? swapRunIndexEntry(history.indexEntries[indexPosition++]) : topTailRuns[tailPosition++]);
+    }
+
+    return topRuns;
+}
+
+bool readRunRecord(RunHistory &history, Uint64 recordIndex, RunRecord &record)
+{
+    if (history.logFile == 0 || recordIndex >= history.recordsCount || !readLogRecords(history.logFile, recordIndex, &record, 1))
+    {
+        return false;
+    }
+
+    record = swapRunRecord(record);
+
+    return true;
+}
@@ -1,58 +1,80 @@
 #include "sdl_assets_loader.h"
+#include "asset_pack.h"
+#include "texture_cache.h"
 
-Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, int positionY)
-{
-    SDL_Rect textureBounds = {positionX, positionY, 0, 0};
-
-    SDL_Texture *texture = IMG_LoadTexture(renderer, filePath);
-
-    if (texture != nullptr)
-    {
-        SDL_QueryTexture(texture, NULL, NULL, &textureBounds.w, &textureBounds.h);
-    }
+AssetPack mountedAssetPack;
 
-    Sprite sprite = {texture, textureBounds}; 
+bool mountAssetPack(const char *packFilePath)
+{
+    unmountAssetPack();
 
-    return sprite;
+    return openAssetPack(mountedAssetPack, packFilePath);
 }
 
-Mix_Chunk *loadSound(const char *filePath)
+void unmountAssetPack()
 {
-    Mix_Chunk *sound = nullptr;
+    closeAssetPack(mountedAssetPack);
+}
 
-    sound = Mix_LoadWAV(filePath);
-    if (sound == nullptr)
+SDL_RWops *openAsset(const char *filePath)
+{
+    if (mountedAssetPack.file.data != nullptr)
     {
-        printf("Failed to load scratch sound effect! SDL_mixer Error: %s\n", Mix_GetError());
+        const AssetPackEntry *entry = findAssetPackEntry(mountedAssetPack, filePath);
+
+        if (entry != nullptr)
+        {
+            return SDL_RWFromConstMem(mountedAssetPack.file.data + SDL_SwapLE64(entry->offset), SDL_SwapLE64(entry->size));
+        }
     }
 
-    return sound;
+    return SDL_RWFromFile(filePath, "rb");
 }
 
-void updateTextureText(SDL_Texture *&texture, const char *text, TTF_Font *&fontSquare, SDL_Renderer *renderer)
+Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, int positionY)
 {
-    SDL_Color fontColor = {255, 255, 255};
+    SDL_Rect textureBounds = {positionX, positionY, 0, 0};
+
+    SDL_Texture *texture = nullptr;
 
-    if (fontSquare == nullptr)
+    // warm starts read the decoded pixels from the texture cache instead of decoding the png.
+    SDL_Surface *surface = loadCachedImage(filePath);
+
+    if (surface != nullptr)
     {
-        printf("TTF_OpenFont fontSquare: %s\n", TTF_GetError());
+        texture = createTextureFromPixels(renderer, surface);
+        SDL_FreeSurface(surface);
     }
 
-    SDL_Surface *surface = TTF_RenderUTF8_Blended(fontSquare, text, fontColor);
-    if (surface == nullptr)
+    if (texture != nullptr)
     {
-        printf("TTF_OpenFont: %s\n", TTF_GetError());
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create text surface! SDL Error: %s\n", SDL_GetError());
-        exit(3);
+        SDL_QueryTexture(texture, NULL, NULL, &textureBounds.w, &textureBounds.h);
     }
 
-    SDL_DestroyTexture(texture);
-    texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture == nullptr)
+    SDL_Rect sourceBounds = {0, 0, textureBounds.w, textureBounds.h};
+
+    Sprite sprite = {texture, textureBounds, sourceBounds};
+
+    return sprite;
+}
+
+Sprite loadSpriteBounds(const char *filePath, int positionX, int positionY)
+{
+    SDL_Rect textureBounds = {positionX, positionY, 0, 0};
+
+    SDL_Surface *surface = IMG_Load_RW(openAsset(filePath), 1);
+
+    if (surface != nullptr)
     {
-        printf("TTF_OpenFont: %s\n", TTF_GetError());
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create texture from surface! SDL Error: %s\n", SDL_GetError());
+        textureBounds.w = surface->w;
+        textureBounds.h = surface->h;
+
+        SDL_FreeSurface(surface);
     }
 
-    SDL_FreeSurface(surface);
-}
\ No newline at end of file
+    SDL_Rect sourceBounds = {0, 0, textureBounds.w, textureBounds.h};
+
+    Sprite sprite = {nullptr, textureBounds, sourceBounds};
+
+    return sprite;
+}
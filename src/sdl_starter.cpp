@@ -1,6 +1,7 @@
 #include "sdl_starter.h"
+#include <cmath>
 
-int startSDL(SDL_Window *window, SDL_Renderer *renderer)
+int startSDL(SDL_Window *window, SDL_Renderer *renderer, bool isMixerEnabled)
 {
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0)
     {
@@ -30,7 +31,7 @@ int startSDL(SDL_Window *window, SDL_Renderer *renderer)
     }
 
     // Initialize SDL_mixer
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
+    if (isMixerEnabled && Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
     {
         printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
         return 1;
@@ -44,12 +45,100 @@ int startSDL(SDL_Window *window, SDL_Renderer *renderer)
     return 0;
 }
 
-void capFrameRate(Uint32 currentFrameTime)
+void initFixedRatePacer(FramePacer &pacer, int rate)
 {
-    Uint32 frameTime = SDL_GetTicks() - currentFrameTime;
+    pacer = FramePacer{};
+    pacer.frequency = SDL_GetPerformanceFrequency();
+    pacer.frameDuration = pacer.frequency / rate;
+    pacer.lastFrameEnd = SDL_GetPerformanceCounter();
+    pacer.nextDeadline = pacer.lastFrameEnd + pacer.frameDuration;
+}
+
+void initFramePacer(FramePacer &pacer, SDL_Window *window, SDL_Renderer *renderer, int frameRate)
+{
+    SDL_RendererInfo rendererInfo;
+    bool isVSyncEnabled = SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && (rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC);
+
+    SDL_DisplayMode displayMode;
+    int refreshRate = 0;
+
+    if (SDL_GetWindowDisplayMode(window, &displayMode) == 0)
+    {
+        refreshRate = displayMode.refresh_rate;
+    }
+
+    if (frameRate <= 0)
+    {
+        frameRate = refreshRate > 0 ? refreshRate : FRAME_RATE;
+    }
+
+    initFixedRatePacer(pacer, frameRate);
+
+    // an unknown refresh rate is reported as 0, trust vsync in that case.
+    pacer.isVSyncPacing = isVSyncEnabled && (refreshRate == 0 || refreshRate == frameRate);
+}
+
+void waitForNextFrame(FramePacer &pacer)
+{
+    const Uint64 spinDuration = pacer.frequency * 2 / 1000;
+
+    if (!pacer.isVSyncPacing)
+    {
+        Uint64 now = SDL_GetPerformanceCounter();
+
+        // more than a frame late, start over from now instead of rushing the next frames.
+        if (now > pacer.nextDeadline + pacer.frameDuration)
+        {
+            pacer.nextDeadline = now;
+        }
 
-    if (frameTime < 1000 / FRAME_RATE)
+        while (now + spinDuration < pacer.nextDeadline)
+        {
+            Uint64 sleepTicks = pacer.nextDeadline - now - spinDuration;
+            Uint32 sleepMilliseconds = (Uint32)(sleepTicks * 1000 / pacer.frequency);
+
+            SDL_Delay(sleepMilliseconds > 0 ? sleepMilliseconds : 1);
+
+            now = SDL_GetPerformanceCounter();
+        }
+
+        while (now < pacer.nextDeadline)
+        {
+            now = SDL_GetPerformanceCounter();
+        }
+
+        pacer.nextDeadline += pacer.frameDuration;
+    }
+
+    Uint64 frameEnd = SDL_GetPerformanceCounter();
+
+    double frameMilliseconds = (double)(frameEnd - pacer.lastFrameEnd) * 1000 / pacer.frequency;
+    double targetMilliseconds = (double)pacer.frameDuration * 1000 / pacer.frequency;
+    double error = frameMilliseconds - targetMilliseconds;
+
+    pacer.measuredFrames++;
+    pacer.errorSum += error;
+    pacer.squaredErrorSum += error * error;
+
+    if (std::abs(error) > pacer.maxError)
     {
-        SDL_Delay(1000 / FRAME_RATE - frameTime);
+        pacer.maxError = std::abs(error);
     }
-}
\ No newline at end of file
+
+    pacer.lastFrameEnd = frameEnd;
+}
+
+void printFramePacerStats(const FramePacer &pacer)
+{
+    if (pacer.measuredFrames == 0)
+    {
+        return;
+    }
+
+    double meanError = pacer.errorSum / pacer.measuredFrames;
+    double variance = pacer.squaredErrorSum / pacer.measuredFrames - meanError * meanError;
+
+    std::cout << "frame pacing: " << pacer.measuredFrames << " frames, target " << (double)pacer.frameDuration * 1000 / pacer.frequency << " ms"
+              << (pacer.isVSyncPacing ? " (vsync)" : "") << "\n";
+    std::cout << "jitter mean: " << meanError << " ms, stddev: " << std::sqrt(variance > 0 ? variance : 0) << " ms, max: " << pacer.maxError << " ms" << std::endl;
+}
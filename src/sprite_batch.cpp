@@ -0,0 +1,139 @@
+#include "sprite_batch.h"
+#include <cmath>
+
+void initSpriteBatch(SpriteBatch &batch, SDL_Renderer *renderer, int quadsCapacity)
+{
+    batch.renderer = renderer;
+    batch.texture = nullptr;
+    batch.textureWidth = 1;
+    batch.textureHeight = 1;
+    batch.drawCalls = 0;
+
+    batch.vertices.reserve(quadsCapacity * 4);
+    batch.indices.reserve(quadsCapacity * 6);
+}
+
+void beginSpriteBatch(SpriteBatch &batch)
+{
+    batch.vertices.clear();
+    batch.indices.clear();
+    batch.drawCalls = 0;
+}
+
+void flushSpriteBatch(SpriteBatch &batch)
+{
+    if (batch.indices.empty())
+    {
+        return;
+    }
+
+    SDL_RenderGeometry(batch.renderer, batch.texture, batch.vertices.data(), batch.vertices.size(), batch.indices.data(), batch.indices.size());
+
+    batch.drawCalls++;
+
+    batch.vertices.clear();
+    batch.indices.clear();
+}
+
+void setBatchTexture(SpriteBatch &batch, SDL_Texture *texture)
+{
+    if (texture == batch.texture)
+    {
+        return;
+    }
+
+    flushSpriteBatch(batch);
+
+    batch.texture = texture;
+    batch.textureWidth = 1;
+    batch.textureHeight = 1;
+
+    if (texture != nullptr)
+    {
+        int width;
+        int height;
+        SDL_QueryTexture(texture, NULL, NULL, &width, &height);
+
+        batch.textureWidth = width;
+        batch.textureHeight = height;
+    }
+}
+
+void addQuad(SpriteBatch &batch, const SDL_FPoint corners[4], const SDL_FPoint textureCoordinates[4], SDL_Color color)
+{
+    int firstVertex = batch.vertices.size();
+
+    for (int i = 0; i < 4; i++)
+    {
+        batch.vertices.push_back({corners[i], color, textureCoordinates[i]});
+    }
+
+    // two triangles: top left, top right, bottom right and top left, bottom right, bottom left.
+    const int quadIndices[6] = {0, 1, 2, 0, 2, 3};
+
+    for (int quadIndex : quadIndices)
+    {
+        batch.indices.push_back(firstVertex + quadIndex);
+    }
+}
+
+void drawTexturedQuad(SpriteBatch &batch, SDL_Texture *texture, const SDL_Rect &source, const SDL_FRect &destination, float angle)
+{
+    setBatchTexture(batch, texture);
+
+    float left = source.x / batch.textureWidth;
+    float top = source.y / batch.textureHeight;
+    float right = (source.x + source.w) / batch.textureWidth;
+    float bottom = (source.y + source.h) / batch.textureHeight;
+
+    SDL_FPoint textureCoordinates[4] = {{left, top}, {right, top}, {right, bottom}, {left, bottom}};
+
+    SDL_FPoint corners[4] = {
+        {destination.x, destination.y},
+        {destination.x + destination.w, destination.y},
+        {destination.x + destination.w, destination.y + destination.h},
+        {destination.x, destination.y + destination.h}};
+
+    if (angle != 0)
+    {
+        float radians = angle * (float)M_PI / 180;
+        float cosine = std::cos(radians);
+        float sine = std::sin(radians);
+
+        float centerX = destination.x + destination.w / 2;
+        float centerY = destination.y + destination.h / 2;
+
+        for (SDL_FPoint &corner : corners)
+        {
+            float offsetX = corner.x - centerX;
+            float offsetY = corner.y - centerY;
+
+            corner.x = centerX + offsetX * cosine - offsetY * sine;
+            corner.y = centerY + offsetX * sine + offsetY * cosine;
+        }
+    }
+
+    addQuad(batch, corners, textureCoordinates, {255, 255, 255, 255});
+}
+
+void drawSprite(SpriteBatch &batch, const Sprite &sprite)
+{
+    SDL_FRect destination = {(float)sprite.textureBounds.x, (float)sprite.textureBounds.y, (float)sprite.textureBounds.w, (float)sprite.textureBounds.h};
+
+    drawTexturedQuad(batch, sprite.texture, sprite.sourceBounds, destination, 0);
+}
+
+void drawFilledQuad(SpriteBatch &batch, const SDL_Rect &bounds, SDL_Color color)
+{
+    setBatchTexture(batch, nullptr);
+
+    float left = bounds.x;
+    float top = bounds.y;
+    float right = bounds.x + bounds.w;
+    float bottom = bounds.y + bounds.h;
+
+    SDL_FPoint corners[4] = {{left, top}, {right, top}, {right, bottom}, {left, bottom}};
+    SDL_FPoint textureCoordinates[4] = {{0, 0}, {0, 0}, {0, 0}, {0, 0}};
+
+    addQuad(batch, corners, textureCoordinates, color);
+}
@@ -0,0 +1,120 @@
+#include "texture_atlas.h"
+#include "texture_cache.h"
+#include <algorithm>
+#include <vector>
+
+// empty pixels between images so scaled or rotated sprites never sample their neighbours.
+const int ATLAS_PADDING = 1;
+
+bool buildTextureAtlas(SDL_Renderer *renderer, AtlasEntry entries[], SDL_Surface *surfaces[], int entriesCount, TextureAtlas &atlas)
+{
+    SDL_RendererInfo rendererInfo;
+    int maxWidth = 2048;
+    int maxHeight = 2048;
+
+    // the software renderer reports 0, meaning no limit.
+    if (SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && rendererInfo.max_texture_width > 0)
+    {
+        maxWidth = std::min(maxWidth, rendererInfo.max_texture_width);
+        maxHeight = std::min(maxHeight, rendererInfo.max_texture_height);
+    }
+
+    bool isLoaded = true;
+
+    for (int i = 0; i < entriesCount; i++)
+    {
+        if (surfaces[i] == nullptr)
+        {
+            printf("Failed to load %s for the texture atlas!\n", entries[i].filePath);
+            isLoaded = false;
+        }
+    }
+
+    // shelf packing: tallest images first, placed left to right in rows as high as their first image.
+    std::vector<int> order(entriesCount);
+
+    for (int i = 0; i < entriesCount; i++)
+    {
+        order[i] = i;
+    }
+
+    if (isLoaded)
+    {
+        std::sort(order.begin(), order.end(), [&](int a, int b)
+                  { return surfaces[a]->h > surfaces[b]->h; });
+    }
+
+    std::vector<SDL_Rect> regions(entriesCount);
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+    int atlasWidth = 0;
+
+    for (int i = 0; i < entriesCount && isLoaded; i++)
+    {
+        SDL_Surface *surface = surfaces[order[i]];
+
+        if (shelfX + surface->w > maxWidth)
+        {
+            shelfY += shelfHeight + ATLAS_PADDING;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+
+        regions[order[i]] = {shelfX, shelfY, surface->w, surface->h};
+
+        shelfX += surface->w + ATLAS_PADDING;
+        shelfHeight = std::max(shelfHeight, surface->h);
+        atlasWidth = std::max(atlasWidth, shelfX);
+    }
+
+    int atlasHeight = shelfY + shelfHeight;
+
+    if (isLoaded && (atlasWidth > maxWidth || atlasHeight > maxHeight))
+    {
+        printf("The texture atlas doesn't fit in %dx%d\n", maxWidth, maxHeight);
+        isLoaded = false;
+    }
+
+    SDL_Surface *atlasSurface = nullptr;
+
+    if (isLoaded)
+    {
+        atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth, atlasHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+        isLoaded = atlasSurface != nullptr;
+    }
+
+    if (isLoaded)
+    {
+        SDL_FillRect(atlasSurface, NULL, SDL_MapRGBA(atlasSurface->format, 0, 0, 0, 0));
+
+        for (int i = 0; i < entriesCount; i++)
+        {
+            // copy the alpha channel as is instead of blending it with the empty atlas.
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surfaces[i], NULL, atlasSurface, &regions[i]);
+        }
+
+        atlas.texture = createTextureFromPixels(renderer, atlasSurface);
+        atlas.width = atlasWidth;
+        atlas.height = atlasHeight;
+
+        isLoaded = atlas.texture != nullptr;
+
+        SDL_FreeSurface(atlasSurface);
+    }
+
+    if (isLoaded)
+    {
+        SDL_SetTextureBlendMode(atlas.texture, SDL_BLENDMODE_BLEND);
+
+        for (int i = 0; i < entriesCount; i++)
+        {
+            SDL_Rect textureBounds = {entries[i].positionX, entries[i].positionY, regions[i].w, regions[i].h};
+
+            *entries[i].sprite = {atlas.texture, textureBounds, regions[i]};
+        }
+    }
+
+    return isLoaded;
+}
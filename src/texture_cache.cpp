@@ -0,0 +1,280 @@
+#include "texture_cache.h"
+#include "sdl_assets_loader.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+std::string textureCacheDirectory;
+
+void initTextureCache(const char *directoryPath)
+{
+    textureCacheDirectory = directoryPath;
+
+    if (textureCacheDirectory.empty())
+    {
+        return;
+    }
+
+    // fails when the folder already exists, which is fine.
+#ifdef _WIN32
+    _mkdir(directoryPath);
+#else
+    mkdir(directoryPath, 0755);
+#endif
+}
+
+bool isTextureCacheEnabled()
+{
+    return !textureCacheDirectory.empty();
+}
+
+Uint64 hashBytes(const void *data, size_t size)
+{
+    const Uint8 *bytes = (const Uint8 *)data;
+    Uint64 hash = 0xCBF29CE484222325ull;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+bool readSourceBytes(const char *filePath, std::vector<Uint8> &bytes)
+{
+    SDL_RWops *source = openAsset(filePath);
+
+    if (source == nullptr)
+    {
+        return false;
+    }
+
+    Sint64 size = SDL_RWsize(source);
+    bytes.resize(size > 0 ? size : 0);
+
+    bool isRead = size > 0 && SDL_RWread(source, bytes.data(), 1, size) == (size_t)size;
+
+    SDL_RWclose(source);
+
+    return isRead;
+}
+
+SDL_Surface *decodeImageBytes(const std::vector<Uint8> &bytes, const char *filePath)
+{
+    SDL_Surface *surface = IMG_Load_RW(SDL_RWFromConstMem(bytes.data(), bytes.size()), 1);
+
+    if (surface == nullptr)
+    {
+        printf("Failed to load %s! SDL_image Error: %s\n", filePath, IMG_GetError());
+        return nullptr;
+    }
+
+    SDL_Surface *convertedSurface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+
+    SDL_FreeSurface(surface);
+
+    return convertedSurface;
+}
+
+SDL_Surface *decodeImage(const char *filePath)
+{
+    std::vector<Uint8> bytes;
+
+    if (!readSourceBytes(filePath, bytes))
+    {
+        printf("Failed to read %s\n", filePath);
+        return nullptr;
+    }
+
+    return decodeImageBytes(bytes, filePath);
+}
+
+std::string getCacheFilePath(const char *filePath)
+{
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "/%016llx.raw", (unsigned long long)hashBytes(filePath, strlen(filePath)));
+
+    return textureCacheDirectory + fileName;
+}
+
+SDL_Surface *readCachedPixels(const std::string &cacheFilePath, Uint64 sourceHash, Uint64 sourceSize)
+{
+    SDL_RWops *cacheFile = SDL_RWFromFile(cacheFilePath.c_str(), "rb");
+
+    if (cacheFile == nullptr)
+    {
+        return nullptr;
+    }
+
+    TextureCacheHeader header;
+    SDL_Surface *surface = nullptr;
+
+    bool isValid = SDL_RWread(cacheFile, &header, sizeof(header), 1) == 1 &&
+                   memcmp(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+                   header.version == TEXTURE_CACHE_VERSION &&
+                   header.sourceHash == sourceHash && header.sourceSize == sourceSize &&
+                   header.pixelFormat == SDL_PIXELFORMAT_ARGB8888 && header.width > 0 && header.height > 0;
+
+    // the pitch of the cached rows can differ from the new surface's, and the file must hold every row.
+    isValid = isValid && header.pitch >= (Sint64)header.width * 4 &&
+              SDL_RWsize(cacheFile) == (Sint64)sizeof(header) + (Sint64)header.pitch * header.height;
+
+    if (isValid)
+    {
+        surface = SDL_CreateRGBSurfaceWithFormat(0, header.width, header.height, 32, SDL_PIXELFORMAT_ARGB8888);
+    }
+
+    if (surface != nullptr)
+    {
+        // only the pixels of a row are copied, whatever padding follows them in the file is skipped.
+        int rowSize = header.width * 4;
+        bool isRead = rowSize <= surface->pitch;
+
+        for (int row = 0; row < header.height && isRead; row++)
+        {
+            isRead = SDL_RWread(cacheFile, (Uint8 *)surface->pixels + row * surface->pitch, rowSize, 1) == 1 &&
+                     SDL_RWseek(cacheFile, header.pitch - rowSize, RW_SEEK_CUR) >= 0;
+        }
+
+        if (!isRead)
+        {
+            SDL_FreeSurface(surface);
+            surface = nullptr;
+        }
+    }
+
+    SDL_RWclose(cacheFile);
+
+    return surface;
+}
+
+void writeCachedPixels(const std::string &cacheFilePath, Uint64 sourceHash, Uint64 sourceSize, SDL_Surface *surface)
+{
+    TextureCacheHeader header;
+    memcpy(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic));
+    header.version = TEXTURE_CACHE_VERSION;
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+    header.pixelFormat = surface->format->format;
+    header.width = surface->w;
+    header.height = surface->h;
+    header.pitch = surface->pitch;
+
+    // written under a name unique to this thread and renamed, so a reader never sees half a file.
+    std::string temporaryFilePath = cacheFilePath + "." + std::to_string(SDL_ThreadID()) + ".tmp";
+
+    SDL_RWops *cacheFile = SDL_RWFromFile(temporaryFilePath.c_str(), "wb");
+
+    if (cacheFile == nullptr)
+    {
+        return;
+    }
+
+    bool isWritten = SDL_RWwrite(cacheFile, &header, sizeof(header), 1) == 1 &&
+                     SDL_RWwrite(cacheFile, surface->pixels, surface->pitch * surface->h, 1) == 1;
+
+    SDL_RWclose(cacheFile);
+
+    if (isWritten)
+    {
+        remove(cacheFilePath.c_str());
+        isWritten = rename(temporaryFilePath.c_str(), cacheFilePath.c_str()) == 0;
+    }
+
+    if (!isWritten)
+    {
+        remove(temporaryFilePath.c_str());
+    }
+}
+
+SDL_Surface *loadCachedImage(const char *filePath)
+{
+    if (!isTextureCacheEnabled())
+    {
+        return decodeImage(filePath);
+    }
+
+    std::vector<Uint8> bytes;
+
+    if (!readSourceBytes(filePath, bytes))
+    {
+        printf("Failed to read %s\n", filePath);
+        return nullptr;
+    }
+
+    Uint64 sourceHash = hashBytes(bytes.data(), bytes.size());
+    std::string cacheFilePath = getCacheFilePath(filePath);
+
+    SDL_Surface *surface = readCachedPixels(cacheFilePath, sourceHash, bytes.size());
+
+    if (surface == nullptr)
+    {
+        surface = decodeImageBytes(bytes, filePath);
+
+        if (surface != nullptr)
+        {
+            writeCachedPixels(cacheFilePath, sourceHash, bytes.size(), surface);
+        }
+    }
+
+    return surface;
+}
+
+SDL_Texture *createTextureFromPixels(SDL_Renderer *renderer, SDL_Surface *surface)
+{
+    SDL_Texture *texture = SDL_CreateTexture(renderer, surface->format->format, SDL_TEXTUREACCESS_STATIC, surface->w, surface->h);
+
+    if (texture == nullptr)
+    {
+        printf("Failed to create a texture! SDL Error: %s\n", SDL_GetError());
+        return nullptr;
+    }
+
+    SDL_UpdateTexture(texture, NULL, surface->pixels, surface->pitch);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    return texture;
+}
+
+double timeImagesLoad(const char *filePaths[], int filePathsCount, int rounds, bool isCached)
+{
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    for (int round = 0; round < rounds; round++)
+    {
+        for (int i = 0; i < filePathsCount; i++)
+        {
+            SDL_FreeSurface(isCached ? loadCachedImage(filePaths[i]) : decodeImage(filePaths[i]));
+        }
+    }
+
+    return (double)(SDL_GetPerformanceCounter() - startCounter) * 1000 / SDL_GetPerformanceFrequency() / rounds;
+}
+
+void benchmarkTextureCache(const char *filePaths[], int filePathsCount, int rounds)
+{
+    if (!isTextureCacheEnabled())
+    {
+        printf("The texture cache is disabled\n");
+        return;
+    }
+
+    // fills the cache, so every measured cached load is a hit.
+    timeImagesLoad(filePaths, filePathsCount, 1, true);
+
+    double coldMilliseconds = timeImagesLoad(filePaths, filePathsCount, rounds, false);
+    double warmMilliseconds = timeImagesLoad(filePaths, filePathsCount, rounds, true);
+
+    printf("%d images, average of %d rounds\n", filePathsCount, rounds);
+    printf("cold start, png decoding: %.3f ms\n", coldMilliseconds);
+    printf("warm start, texture cache: %.3f ms\n", warmMilliseconds);
+}
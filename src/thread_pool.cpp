@@ -0,0 +1,209 @@
+#include "thread_pool.h"
+#include <cstdio>
+
+bool takeOwnTask(WorkerTasks &tasks, int &index)
+{
+    SDL_AtomicLock(&tasks.lock);
+
+    bool hasTask = tasks.begin < tasks.end;
+
+    if (hasTask)
+    {
+        index = tasks.begin++;
+    }
+
+    SDL_AtomicUnlock(&tasks.lock);
+
+    return hasTask;
+}
+
+bool stealTasks(ThreadPool &pool, int workerIndex)
+{
+    for (int i = 1; i < pool.workersCount; i++)
+    {
+        WorkerTasks &victim = pool.tasks[(workerIndex + i) % pool.workersCount];
+
+        SDL_AtomicLock(&victim.lock);
+
+        int remaining = victim.end - victim.begin;
+        int stolenBegin = victim.end - (remaining + 1) / 2;
+        int stolenEnd = victim.end;
+
+        if (remaining > 0)
+        {
+            victim.end = stolenBegin;
+        }
+
+        SDL_AtomicUnlock(&victim.lock);
+
+        if (remaining > 0)
+        {
+            WorkerTasks &tasks = pool.tasks[workerIndex];
+
+            SDL_AtomicLock(&tasks.lock);
+            tasks.begin = stolenBegin;
+            tasks.end = stolenEnd;
+            SDL_AtomicUnlock(&tasks.lock);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void runWorkerTasks(ThreadPool &pool, int workerIndex)
+{
+    int index;
+
+    do
+    {
+        while (takeOwnTask(pool.tasks[workerIndex], index))
+        {
+            pool.task(pool.taskData, index);
+        }
+    } while (stealTasks(pool, workerIndex));
+}
+
+int runWorker(void *data)
+{
+    ThreadPool &pool = *((PoolWorker *)data)->pool;
+    int workerIndex = ((PoolWorker *)data)->workerIndex;
+    int batch = 0;
+
+    SDL_LockMutex(pool.mutex);
+
+    while (true)
+    {
+        while (pool.batch == batch && !pool.isStopping)
+        {
+            SDL_CondWait(pool.batchStarted, pool.mutex);
+        }
+
+        if (pool.isStopping)
+        {
+            break;
+        }
+
+        batch = pool.batch;
+
+        SDL_UnlockMutex(pool.mutex);
+        runWorkerTasks(pool, workerIndex);
+        SDL_LockMutex(pool.mutex);
+
+        pool.busyWorkers--;
+
+        if (pool.busyWorkers == 0)
+        {
+            SDL_CondSignal(pool.batchFinished);
+        }
+    }
+
+    SDL_UnlockMutex(pool.mutex);
+
+    return 0;
+}
+
+void startThreadPool(ThreadPool &pool, int workersCount)
+{
+    pool = ThreadPool{};
+
+    if (workersCount <= 0)
+    {
+        workersCount = SDL_GetCPUCount();
+    }
+
+    workersCount = SDL_clamp(workersCount, 1, THREAD_POOL_MAX_WORKERS);
+
+    pool.workersCount = 1;
+    pool.mutex = SDL_CreateMutex();
+    pool.batchStarted = SDL_CreateCond();
+    pool.batchFinished = SDL_CreateCond();
+
+    if (pool.mutex == nullptr || pool.batchStarted == nullptr || pool.batchFinished == nullptr)
+    {
+        printf("Failed to create the thread pool, running on one thread: %s\n", SDL_GetError());
+        return;
+    }
+
+    // the workers only ever steal from the ones that started, so it's fine if some fail.
+    for (int i = 1; i < workersCount; i++)
+    {
+        pool.workers[pool.workersCount] = {&pool, pool.workersCount};
+
+        SDL_Thread *thread = SDL_CreateThread(runWorker, "pool worker", &pool.workers[pool.workersCount]);
+
+        if (thread == nullptr)
+        {
+            printf("Failed to start a pool worker: %s\n", SDL_GetError());
+            break;
+        }
+
+        pool.threads[pool.workersCount] = thread;
+        pool.workersCount++;
+    }
+}
+
+void runThreadPoolTasks(ThreadPool &pool, int tasksCount, ThreadPoolTask task, void *data)
+{
+    if (pool.workersCount == 1)
+    {
+        for (int i = 0; i < tasksCount; i++)
+        {
+            task(data, i);
+        }
+
+        return;
+    }
+
+    SDL_LockMutex(pool.mutex);
+
+    pool.task = task;
+    pool.taskData = data;
+
+    // an even split to start with, stealing evens out the tasks that take longer.
+    for (int i = 0; i < pool.workersCount; i++)
+    {
+        pool.tasks[i].begin = (int)((long long)tasksCount * i / pool.workersCount);
+        pool.tasks[i].end = (int)((long long)tasksCount * (i + 1) / pool.workersCount);
+    }
+
+    pool.busyWorkers = pool.workersCount - 1;
+    pool.batch++;
+
+    SDL_CondBroadcast(pool.batchStarted);
+    SDL_UnlockMutex(pool.mutex);
+
+    runWorkerTasks(pool, 0);
+
+    SDL_LockMutex(pool.mutex);
+
+    while (pool.busyWorkers > 0)
+    {
+        SDL_CondWait(pool.batchFinished, pool.mutex);
+    }
+
+    SDL_UnlockMutex(pool.mutex);
+}
+
+void stopThreadPool(ThreadPool &pool)
+{
+    if (pool.mutex != nullptr)
+    {
+        SDL_LockMutex(pool.mutex);
+        pool.isStopping = true;
+        SDL_CondBroadcast(pool.batchStarted);
+        SDL_UnlockMutex(pool.mutex);
+    }
+
+    for (int i = 1; i < pool.workersCount; i++)
+    {
+        SDL_WaitThread(pool.threads[i], nullptr);
+    }
+
+    SDL_DestroyCond(pool.batchFinished);
+    SDL_DestroyCond(pool.batchStarted);
+    SDL_DestroyMutex(pool.mutex);
+
+    pool = ThreadPool{};
+}
@@ -0,0 +1,44 @@
+#include "triple_buffer.h"
+
+void initTripleBuffer(TripleBuffer &buffer)
+{
+    buffer.backSlot = 0;
+    SDL_AtomicSet(&buffer.middleSlot, 1);
+    buffer.frontSlot = 2;
+}
+
+int getTripleBufferBack(const TripleBuffer &buffer)
+{
+    return buffer.backSlot;
+}
+
+void publishTripleBuffer(TripleBuffer &buffer)
+{
+    // the writes to the back slot have to be visible before the consumer can take it.
+    SDL_MemoryBarrierRelease();
+
+    int previousMiddle = SDL_AtomicSet(&buffer.middleSlot, buffer.backSlot | TRIPLE_BUFFER_FRESH);
+
+    buffer.backSlot = previousMiddle & ~TRIPLE_BUFFER_FRESH;
+}
+
+bool takeTripleBufferFront(TripleBuffer &buffer)
+{
+    if ((SDL_AtomicGet(&buffer.middleSlot) & TRIPLE_BUFFER_FRESH) == 0)
+    {
+        return false;
+    }
+
+    int previousMiddle = SDL_AtomicSet(&buffer.middleSlot, buffer.frontSlot);
+
+    buffer.frontSlot = previousMiddle & ~TRIPLE_BUFFER_FRESH;
+
+    SDL_MemoryBarrierAcquire();
+
+    return true;
+}
+
+int getTripleBufferFront(const TripleBuffer &buffer)
+{
+    return buffer.frontSlot;
+}